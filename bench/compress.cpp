@@ -0,0 +1,157 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Measures block compression throughput and ratio on synthetic log text shaped like a real play session: level
+// prefixes, repeated message templates, counters, coordinates, addresses and paths.
+//
+// Usage: axologl-bench-compress [megabytes]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "compress.h"
+
+namespace
+{
+    std::string generateLog(const std::size_t targetSize)
+    {
+        static const char* prefixes[] = {"[DEBUG] ", "[INFO] ", "[NOTICE] ", "[WARN] ", "[ERROR] "};
+        static const char* entities[] = {"player", "enemy_slime", "npc_merchant", "projectile", "door_03"};
+        static const char* assets[] = {"romfs:/textures/tiles.png", "romfs:/audio/bgm_field.ogg",
+                                       "sdmc:/switch/game/save.bin", "romfs:/maps/level_2.tmx"};
+
+        std::string log;
+        log.reserve(targetSize + 256);
+        std::uint32_t state = 0x12345678;
+        const auto next = [&state]() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        };
+
+        char line[256];
+        std::uint32_t frame = 0;
+        while (log.size() < targetSize)
+        {
+            const std::uint32_t r = next();
+            const char* prefix = prefixes[(r & 0xFF) < 200 ? 0 : 1 + (r >> 8) % 4];
+            int length = 0;
+            switch ((r >> 16) % 6)
+            {
+            case 0:
+                length = snprintf(line, sizeof(line), "%sframe %u took %u.%03u ms", prefix, frame++,
+                                  16 + next() % 4, next() % 1000);
+                break;
+            case 1:
+                length = snprintf(line, sizeof(line), "%s%s moved to (%d, %d) velocity %d.%02d", prefix,
+                                  entities[next() % 5], static_cast<int>(next() % 4096), static_cast<int>(next() % 2048),
+                                  static_cast<int>(next() % 12), static_cast<int>(next() % 100));
+                break;
+            case 2:
+                length = snprintf(line, sizeof(line), "%sloaded %s (%u bytes) in %u us", prefix,
+                                  assets[next() % 4], next() % 1000000, next() % 50000);
+                break;
+            case 3:
+                length = snprintf(line, sizeof(line), "%sheap: used=%u free=%u largest=%u", prefix,
+                                  next() % 0x4000000, next() % 0x4000000, next() % 0x1000000);
+                break;
+            case 4:
+                length = snprintf(line, sizeof(line), "%sipc reply 0x%08x from session %u", prefix, next(),
+                                  next() % 64);
+                break;
+            default:
+                length = snprintf(line, sizeof(line), "%sinput: buttons=0x%04x stick=(%d,%d)", prefix,
+                                  next() & 0xFFFF, static_cast<int>(next() % 65536) - 32768,
+                                  static_cast<int>(next() % 65536) - 32768);
+                break;
+            }
+            log.append(line, length);
+            log.push_back('\n');
+        }
+        return log;
+    }
+
+    double seconds(const std::chrono::steady_clock::duration d)
+    {
+        return std::chrono::duration<double>(d).count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    const std::string log = generateLog(megabytes * 1024 * 1024);
+    const std::size_t blockSize = axologl::compress::maxBlockSize;
+
+    axologl::compress::BlockCompressor compressor;
+    std::vector<char> compressed(axologl::compress::compressBound(blockSize));
+    std::vector<std::vector<char>> blocks;
+    std::size_t compressedTotal = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t offset = 0; offset < log.size(); offset += blockSize)
+    {
+        const std::size_t size = std::min(blockSize, log.size() - offset);
+        const std::size_t out = compressor.compress(log.data() + offset, size, compressed.data(), compressed.size());
+        compressedTotal += out;
+        blocks.emplace_back(compressed.data(), compressed.data() + out);
+    }
+    const double compressTime = seconds(std::chrono::steady_clock::now() - start);
+
+    // Every block is decoded into its place in one buffer, so the round trip can be compared byte for byte
+    std::string decoded(log.size(), '\0');
+    std::size_t decompressedTotal = 0;
+    bool ok = true;
+    start = std::chrono::steady_clock::now();
+    for (const auto& block : blocks)
+    {
+        const std::size_t capacity = std::min(blockSize, decoded.size() - decompressedTotal);
+        std::size_t written = 0;
+        ok &= axologl::compress::decompress(block.data(), block.size(), decoded.data() + decompressedTotal, capacity,
+                                           written);
+        decompressedTotal += written;
+    }
+    const double decompressTime = seconds(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    std::uint32_t sum = 0;
+    for (std::size_t offset = 0; offset < log.size(); offset += blockSize)
+    {
+        sum ^= axologl::compress::checksum(log.data() + offset, std::min(blockSize, log.size() - offset));
+    }
+    const double checksumTime = seconds(std::chrono::steady_clock::now() - start);
+
+    const double mb = static_cast<double>(log.size()) / (1024.0 * 1024.0);
+    printf("input:       %.1f MiB of log text in %zu blocks\n", mb, blocks.size());
+    printf("ratio:       %.2fx (%zu -> %zu bytes)\n", static_cast<double>(log.size()) / compressedTotal, log.size(),
+           compressedTotal);
+    printf("compress:    %.1f MiB/s\n", mb / compressTime);
+    printf("decompress:  %.1f MiB/s\n", mb / decompressTime);
+    printf("checksum:    %.1f MiB/s (%08x)\n", mb / checksumTime, sum);
+
+    if (!ok || decompressedTotal != log.size() || decoded != log)
+    {
+        fprintf(stderr, "round trip failed\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Measures what each durability level costs a writer: throughput, per-record latency and how many syncs were needed.
+// One record in 20 is an Error, which is what `Durability::OnError` syncs on; with several writers the group commit
+// shows up as far fewer syncs than Error records.
+//
+// Usage: axologl-bench-durability [directory] [records per thread] [max threads]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "file.h"
+
+namespace
+{
+    struct Level
+    {
+        const char* name;
+        axologl::Durability durability;
+    };
+
+    void run(const fs::path& directory, const Level& level, const std::size_t threads, const std::size_t records)
+    {
+        const fs::path path = directory / (std::string("bench-") + level.name + ".log");
+        fs::remove(path);
+
+        axologl::LatencyHistogram latency;
+        const std::uint64_t syncsBefore = axologl::_stats.syncs.load();
+        const auto start = std::chrono::steady_clock::now();
+        {
+            axologl::FileLogger logger(path, false, false, level.durability, std::chrono::milliseconds(100));
+            if (!logger.ready())
+            {
+                fprintf(stderr, "unable to open %s\n", path.c_str());
+                std::exit(1);
+            }
+
+            std::vector<std::thread> writers;
+            for (std::size_t t = 0; t < threads; t++)
+            {
+                writers.emplace_back([&logger, &latency, t, records]() {
+                    std::string text;
+                    for (std::size_t i = 0; i < records; i++)
+                    {
+                        const bool isError = i % 20 == 19;
+                        text = std::string(isError ? "[ERROR] " : "[INFO] ") + "writer " + std::to_string(t)
+                            + " record " + std::to_string(i) + " frame took 16.667 ms, heap used 41943040";
+                        const axologl::clock::Ticks begin = axologl::clock::now();
+                        logger.log(text, isError ? axologl::Error : axologl::Info);
+                        latency.recordTicks(begin);
+                    }
+                });
+            }
+            for (auto& writer : writers)
+            {
+                writer.join();
+            }
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const std::uint64_t syncs = axologl::_stats.syncs.load() - syncsBefore;
+        fs::remove(path);
+
+        const axologl::HistogramSnapshot snapshot = latency.snapshot();
+        printf("%-9s %2zu thread(s): %10.0f records/s  p50 %8llu ns  p99 %9llu ns  p999 %9llu ns  %6llu syncs\n",
+               level.name, threads, static_cast<double>(threads * records) / elapsed,
+               static_cast<unsigned long long>(snapshot.percentile(0.5)),
+               static_cast<unsigned long long>(snapshot.percentile(0.99)),
+               static_cast<unsigned long long>(snapshot.percentile(0.999)),
+               static_cast<unsigned long long>(syncs));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const fs::path directory = argc > 1 ? argv[1] : ".";
+    const std::size_t records = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+    const std::size_t maxThreads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4;
+
+    static const Level levels[] = {
+        {"none", axologl::Durability::None},
+        {"on-error", axologl::Durability::OnError},
+        {"periodic", axologl::Durability::Periodic},
+    };
+    for (const Level& level : levels)
+    {
+        for (std::size_t threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            run(directory, level, threads, records);
+        }
+    }
+    return 0;
+}
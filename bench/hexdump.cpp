@@ -0,0 +1,118 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Measures hex dump encoding throughput for each encoder this CPU supports, against the scalar encoder and against
+// the hand-rolled `snprintf` loop callers used before `axologl::hexdump()`. Every encoder's output is checked against
+// the scalar one first.
+//
+// Usage: axologl-bench-hexdump [megabytes per run]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "hexdump.h"
+
+namespace
+{
+    // What callers wrote by hand: one `snprintf` per byte, appended to a growing string
+    void handRolled(const std::vector<std::uint8_t>& data, std::string& out)
+    {
+        out.clear();
+        char hex[4];
+        for (std::size_t i = 0; i < data.size(); i++)
+        {
+            snprintf(hex, sizeof(hex), "%02x ", data[i]);
+            out += hex;
+            if (i % axologl::hex::bytesPerLine == axologl::hex::bytesPerLine - 1) out += '\n';
+        }
+    }
+
+    template <typename Encode>
+    void run(const char* name, const std::vector<std::uint8_t>& data, const std::size_t totalBytes, Encode&& encode)
+    {
+        const std::size_t iterations = std::max<std::size_t>(1, totalBytes / data.size());
+        std::string out;
+        encode(out);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            encode(out);
+            // Keeps the compiler from dropping the work
+            asm volatile("" : : "r"(out.data()) : "memory");
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        printf("%-12s %6zu bytes: %9.1f MB/s  %10.1f ns/dump\n", name, data.size(),
+               static_cast<double>(iterations * data.size()) / elapsed / 1e6, elapsed * 1e9 / iterations);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using axologl::hex::Encoder;
+    const std::size_t totalBytes = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64) * 1024 * 1024;
+
+    static const struct
+    {
+        const char* name;
+        Encoder encoder;
+    } encoders[] = {
+        {"scalar", Encoder::Scalar},
+        {"ssse3", Encoder::Ssse3},
+        {"avx2", Encoder::Avx2},
+        {"neon", Encoder::Neon},
+    };
+
+    std::mt19937 random(42);
+    for (const std::size_t size : {64, 1024, 16 * 1024, 64 * 1024 + 7})
+    {
+        std::vector<std::uint8_t> data(size);
+        for (auto& byte : data)
+        {
+            byte = static_cast<std::uint8_t>(random());
+        }
+
+        std::string expected(axologl::hex::dumpSize(size), '\0');
+        axologl::hex::encode(data.data(), size, expected.data(), Encoder::Scalar);
+
+        run("snprintf", data, totalBytes, [&data](std::string& out) { handRolled(data, out); });
+        for (const auto& [name, encoder] : encoders)
+        {
+            if (!axologl::hex::supported(encoder)) continue;
+
+            std::string check(expected.size(), '\0');
+            axologl::hex::encode(data.data(), size, check.data(), encoder);
+            if (check != expected)
+            {
+                fprintf(stderr, "%s output differs from scalar for %zu bytes\n", name, size);
+                return 1;
+            }
+
+            run(name, data, totalBytes, [&data, encoder](std::string& out) {
+                out.resize(axologl::hex::dumpSize(data.size()));
+                axologl::hex::encode(data.data(), data.size(), out.data(), encoder);
+            });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Measures what sanitizing costs per message. Clean text is compared with a plain copy of the same size, which is
+// the cost the stage should stay close to, and with a byte-at-a-time scan. Text with an escape sequence every few
+// dozen bytes shows the cost when something does need escaping.
+//
+// Usage: axologl-bench-sanitize [megabytes per run]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "sanitize.h"
+
+namespace
+{
+    template <typename Work>
+    void run(const char* name, const std::string& text, const std::size_t totalBytes, Work&& work)
+    {
+        const std::size_t iterations = std::max<std::size_t>(1, totalBytes / text.size());
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            work();
+            // Keeps the compiler from dropping the work
+            asm volatile("" : : : "memory");
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        printf("%-14s %6zu bytes: %9.1f MB/s  %9.1f ns/message\n", name, text.size(),
+               static_cast<double>(iterations * text.size()) / elapsed / 1e6, elapsed * 1e9 / iterations);
+    }
+
+    std::string repeat(const std::string& piece, const std::size_t size)
+    {
+        std::string text;
+        while (text.size() < size)
+        {
+            text += piece;
+        }
+        text.resize(size);
+        return text;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t totalBytes = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256) * 1024 * 1024;
+
+    for (const std::size_t size : {64, 256, 4096, 64 * 1024})
+    {
+        const std::string clean = repeat("Loaded save slot 3 from sdmc:/switch/game/save.bin in 12 ms; ", size);
+        const std::string dirty = repeat("player name \x1b[2J\x07 from the lobby; ", size);
+        std::string out(size * 4, '\0');
+
+        run("memcpy", clean, totalBytes, [&clean, &out]() {
+            std::memcpy(out.data(), clean.data(), clean.size());
+        });
+        run("scan (scalar)", clean, totalBytes, [&clean]() {
+            volatile std::size_t end = axologl::sanitize::detail::findSuspectScalar(clean, 0);
+            (void)end;
+        });
+        run("escape clean", clean, totalBytes, [&clean, &out]() {
+            volatile bool escaped = axologl::sanitize::escape(clean, out);
+            (void)escaped;
+        });
+        run("escape dirty", dirty, totalBytes, [&dirty, &out]() {
+            volatile bool escaped = axologl::sanitize::escape(dirty, out);
+            (void)escaped;
+        });
+    }
+    return 0;
+}
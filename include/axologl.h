@@ -18,10 +18,18 @@
 
 #ifndef AXOLOGL_AXOLOGL_H
 #define AXOLOGL_AXOLOGL_H
+#include <atomic>
+#include <memory>
 #include <string>
-#include <switch.h>
+#include <vector>
 
+#include "channel.h"
+#include "early.h"
 #include "file.h"
+#include "location.h"
+#include "platform.h"
+#include "stats.h"
+#include "tail.h"
 #include "types.h"
 #include "loggers/debug.h"
 #include "loggers/info.h"
@@ -42,9 +50,12 @@ namespace axologl
         logger::ErrorLogger errorLogger;
         logger::FatalLogger fatalLogger;
         logger::RawLogger rawLogger;
-        bool nxlinkEnabled = false;
+        // Atomic so that nxlink can be toggled while other threads are logging
+        std::atomic<bool> nxlinkEnabled = false;
+        std::atomic<bool> shutDown = false;
         PrintConsole* console = nullptr;
 
+    public:
         bool canLogToConsole() const {
             bool consoleAvailable = false;
             if (console) {
@@ -55,9 +66,21 @@ namespace axologl
             return consoleAvailable || nxlinkEnabled;
         }
 
-    public:
-        explicit Axologl(const NxLinkOptions& opts, PrintConsole* console) : console(console)
+        /**
+         * @param opts              nxlink options
+         * @param console           The console to check before printing, or `nullptr` for libnx's default
+         * @param filePattern       Layout for the log file (see `Layout`)
+         * @param consolePattern    Layout for stdout and stderr
+         */
+        explicit Axologl(const NxLinkOptions& opts, PrintConsole* console,
+                         const std::string_view filePattern = defaultPattern,
+                         const std::string_view consolePattern = defaultPattern) : console(console)
         {
+            for (int level = Debug; level <= Raw; level++)
+            {
+                getLogger(static_cast<LogLevel>(level)).setPatterns(filePattern, consolePattern);
+            }
+
             if (opts.enable)
             {
                 enableNxLink(opts);
@@ -67,8 +90,19 @@ namespace axologl
 
         ~Axologl()
         {
+            shutdown();
+        }
+
+        /**
+         * Release the console and nxlink. The instance can still be logged through afterwards, by a thread that loaded
+         * it just before `teardown()`; only the first call does anything.
+         */
+        void shutdown()
+        {
+            if (shutDown.exchange(true)) return;
             debug("Axologl shutting down...");
-            if (nxlinkEnabled)
+            Logger::flushConsole();
+            if (nxlinkEnabled.exchange(false))
             {
                 socketExit();
             }
@@ -76,9 +110,8 @@ namespace axologl
 
         void enableNxLink(const NxLinkOptions& opts)
         {
-            if (!nxlinkEnabled)
+            if (!nxlinkEnabled.exchange(true))
             {
-                nxlinkEnabled = true;
                 socketInitializeDefault();
                 nxlinkConnectToHost(opts.redirectStdout, opts.redirectStderr);
             }
@@ -86,10 +119,11 @@ namespace axologl
 
         void disableNxLink()
         {
-            if (nxlinkEnabled)
+            if (nxlinkEnabled.exchange(false))
             {
+                // Lines still queued for the console would otherwise be lost with the socket
+                Logger::flushConsole();
                 socketExit();
-                nxlinkEnabled = false;
             }
         }
 
@@ -103,48 +137,93 @@ namespace axologl
             return nxlinkEnabled;
         }
 
-        void debug(std::string text)
+        Logger& getLogger(const LogLevel level)
         {
-            this->debugLogger.log(text, canLogToConsole());
+            switch (level)
+            {
+            case Debug: return debugLogger;
+            case Info: return infoLogger;
+            case Notice: return noticeLogger;
+            case Warning: return warnLogger;
+            case Error: return errorLogger;
+            case Fatal: return fatalLogger;
+            default: return rawLogger;
+            }
         }
 
-        void info(std::string text)
+        void debug(const std::string& text, const SiteId site = noSite)
         {
-            this->infoLogger.log(text, canLogToConsole());
+            this->debugLogger.log(text, canLogToConsole(), nullptr, site);
         }
 
-        void notice(std::string text)
+        void info(const std::string& text, const SiteId site = noSite)
         {
-            this->noticeLogger.log(text, canLogToConsole());
+            this->infoLogger.log(text, canLogToConsole(), nullptr, site);
         }
 
-        void warn(std::string text)
+        void notice(const std::string& text, const SiteId site = noSite)
         {
-            this->warnLogger.log(text, canLogToConsole());
+            this->noticeLogger.log(text, canLogToConsole(), nullptr, site);
         }
 
-        void error(std::string text)
+        void warn(const std::string& text, const SiteId site = noSite)
         {
-            this->errorLogger.log(text, canLogToConsole());
+            this->warnLogger.log(text, canLogToConsole(), nullptr, site);
         }
 
-        void fatal(std::string text)
+        void error(const std::string& text, const SiteId site = noSite)
         {
-            this->fatalLogger.log(text, canLogToConsole());
+            this->errorLogger.log(text, canLogToConsole(), nullptr, site);
         }
 
-        void log(std::string text, const std::string* ansiCode = nullptr)
+        void fatal(const std::string& text, const SiteId site = noSite)
+        {
+            this->fatalLogger.log(text, canLogToConsole(), nullptr, site);
+        }
+
+        void log(const std::string& text, const std::string* ansiCode = nullptr)
         {
             this->rawLogger.log(text, canLogToConsole(), ansiCode);
         }
     };
 
-    inline std::unique_ptr<Axologl> _axologl = nullptr;
+    // The configured instance, or `nullptr` before `configure()` and after `teardown()`. Load it once per use.
+    inline std::atomic<Axologl*> _axologl = nullptr;
     inline std::unique_ptr<FileLogger> _fileLogger = nullptr;
-    inline LogLevel _logLevel;
-    inline bool _ansi = false;
+    inline std::unique_ptr<LogTail> _tail = nullptr;
+    // Every instance configured so far. They are only destroyed at exit (before the file logger, which their last
+    // records go to), so that a thread that loaded `_axologl` just before `teardown()` never logs through a destroyed
+    // one.
+    inline std::vector<std::unique_ptr<Axologl>> _instances;
+    inline SharedChannel* _channel = nullptr;
+    // Atomic because they can be changed at runtime while other threads are logging
+    inline std::atomic<LogLevel> _logLevel = Warning;
+    inline std::atomic<bool> _ansi = false;
+    inline std::atomic<bool> _sourceLocation = true;
+    inline std::atomic<bool> _shortSourcePaths = true;
+    inline std::atomic<bool> _sanitizeConsole = false;
+    inline std::atomic<bool> _sanitizeFile = false;
+    inline std::atomic<bool> _asyncConsole = false;
     inline bool _logfileEnabled = false;
+    inline bool _logfileCompressed = false;
+    inline bool _logfileIndexed = false;
     inline std::string _logPath;
+    // Run at the end of `configure()`; `crash::install()` sets it to lay out its crash record with the new patterns
+    inline void (*_onConfigure)() = nullptr;
+
+    /**
+     * Hold a record logged while Axologl isn't configured, for the next `configure()` to replay, unless the current
+     * log level filters it out. Set the level with `setLogLevel()` before `configure()` to keep early debug records.
+     */
+    inline void defer(const LogLevel level, const std::string_view text, const SiteId site = noSite)
+    {
+        if (level < _logLevel.load(std::memory_order_relaxed))
+        {
+            Stats::add(_stats.filtered[level]);
+            return;
+        }
+        early::push(level, text, site);
+    }
 
     /**
      * Configure Axologl for use with the specified options. This should be called as early as possible.
@@ -153,36 +232,141 @@ namespace axologl
      */
     inline void configure(const AxologlOptions& options)
     {
-        if (_axologl != nullptr)
+        if (Axologl* const configured = _axologl.load(std::memory_order_acquire); configured != nullptr)
         {
-            _axologl->error("Axologl has already been configured!");
-            _axologl->error("If you need to change the configuration options, make use of the `set<option>` commands.");
+            configured->error("Axologl has already been configured!");
+            configured->error("If you need to change the configuration options, make use of the `set<option>` "
+                              "commands.");
             return;
         }
 
         _logLevel = options.logLevel;
         _ansi = options.ansiOutput;
-
-        if (!options.logPath.empty())
+        _sourceLocation = options.sourceLocation;
+        _shortSourcePaths = options.shortSourcePaths;
+        _sanitizeConsole = options.sanitizeConsole;
+        _sanitizeFile = options.sanitizeFile;
+        _asyncConsole = options.asyncConsole;
+
+        // Reading the log back (queries through the index, paging the tail) needs each line's level
+        const bool readable = LevelLocator(options.filePattern).readable();
+        bool unreadableIndex = false;
+        if (options.channel != nullptr && options.channel->ready())
+        {
+            _channel = options.channel;
+        }
+        else if (!options.logPath.empty())
         {
             _logPath = options.logPath;
-            _fileLogger = std::make_unique<FileLogger>(options.logPath);
+            _fileLogger = std::make_unique<FileLogger>(options.logPath, options.compressLog,
+                                                       options.indexLog && readable, options.durability,
+                                                       options.syncInterval, options.filePattern);
             _logfileEnabled = _fileLogger && _fileLogger->ready();
+            _logfileCompressed = options.compressLog;
+            _logfileIndexed = options.indexLog && readable;
+            unreadableIndex = options.indexLog && !readable;
+        }
+
+        bool unpageableTail = false;
+        if (options.tailRecords > 0)
+        {
+            // Older records can only be paged back in from a plain-text log
+            const bool plainText = _logfileEnabled && !_fileLogger->isCompressed();
+            unpageableTail = plainText && !readable;
+            _tail = std::make_unique<LogTail>(options.tailRecords,
+                                              plainText && readable ? _fileLogger->getLogPath() : fs::path(),
+                                              [] { return _fileLogger ? _fileLogger->writtenSize() : noFileOffset; },
+                                              options.filePattern);
+        }
+
+        Axologl* const instance = _instances.emplace_back(std::make_unique<Axologl>(
+            options.nxLinkOpts, options.console, options.filePattern, options.consolePattern)).get();
+        _axologl.store(instance, std::memory_order_release);
+        if (!_logfileEnabled && _channel == nullptr)
+        {
+            instance->error("Unable to create file logger; file logging disabled!");
+        }
+        if (unreadableIndex || unpageableTail)
+        {
+            const char* disabled = unreadableIndex ? unpageableTail ? "indexing and tail paging are" : "indexing is"
+                                                   : "tail paging is";
+            instance->warn(std::string("filePattern has no %L ahead of %m or %s, so levels can't be read back from "
+                                       "the log; ") + disabled + " disabled");
         }
 
-        _axologl = std::make_unique<Axologl>(options.nxLinkOpts, options.console);
-        if (!_logfileEnabled)
+        for (std::size_t level = 0; level < levelCount; level++)
         {
-            _axologl->error("Unable to create file logger; file logging disabled!");
+            OverloadPolicy policy = options.overload[level];
+            // Errors are what a slow sink must never lose
+            if (level == Error || level == Fatal) policy.action = Overload::Block;
+            instance->getLogger(static_cast<LogLevel>(level)).setOverloadPolicy(policy);
         }
+        Logger::setDropReporter(&instance->getLogger(Warning), instance->canLogToConsole());
+
+        // Anything logged before now, with the time it was logged at
+        const std::size_t dropped = early::replay([instance](const Record& record) {
+            instance->getLogger(record.level).log(record, instance->canLogToConsole());
+        });
+        if (dropped != 0)
+        {
+            Stats::add(_stats.drops, dropped);
+            instance->warn(std::to_string(dropped) + " records logged before configure() were dropped");
+        }
+        if (_onConfigure != nullptr) _onConfigure();
     }
 
     /**
-     * Perform clean-up related to the library. This should be called before `consoleExit()`.
+     * @return The in-memory record tail for log viewers, or `nullptr` if `AxologlOptions::tailRecords` was 0
+     */
+    inline LogTail* tail()
+    {
+        return _tail.get();
+    }
+
+    /**
+     * Flush the log file and wait until everything logged so far is on storage, e.g. before a risky operation.
+     * Does nothing when logging through a shared-memory channel.
+     */
+    inline void sync()
+    {
+        if (_fileLogger != nullptr) _fileLogger->sync();
+    }
+
+    /**
+     * Write a record from `ChannelCollector::collect()` to this process's log. Records from producers are laid out
+     * already and go straight to the log file; the collector's own notices are logged like any other record, with
+     * this process's layouts.
+     *
+     * @param record    A record handed to the collector's sink
+     */
+    inline void logCollected(const ChannelRecord& record)
+    {
+        if (record.formatted)
+        {
+            if (_fileLogger != nullptr) _fileLogger->log(record.text, record.level);
+            return;
+        }
+
+        Axologl* const instance = _axologl.load(std::memory_order_acquire);
+        if (instance == nullptr) return defer(record.level, record.text);
+        const Record notice{record.level, record.text, noSite, wallClockMs(), currentThreadId()};
+        instance->getLogger(record.level).log(notice, instance->canLogToConsole());
+    }
+
+    /**
+     * Perform clean-up related to the library. This should be called before `consoleExit()`. Anything logged after
+     * this is held, like before `configure()`, until Axologl is configured again.
      */
     inline void teardown()
     {
-        _axologl.reset();
+        Axologl* const instance = _axologl.exchange(nullptr, std::memory_order_acq_rel);
+        if (instance != nullptr)
+        {
+            Logger::setDropReporter(nullptr, instance->canLogToConsole());
+            // Other threads may still hold it, so it is shut down here but only destroyed at exit
+            instance->shutdown();
+        }
+        _channel = nullptr;
     }
 
     /**
@@ -190,20 +374,60 @@ namespace axologl
      */
     inline void printConfiguration()
     {
-        _axologl->debug("Axologl Configuration:");
-        _axologl->debug("Log Level: " + std::to_string(_logLevel));
+        Axologl* const instance = _axologl.load(std::memory_order_acquire);
+        if (instance == nullptr) return;
+
+        instance->debug("Axologl Configuration:");
+        instance->debug("Log Level: " + std::to_string(_logLevel.load()));
         const std::string nxlinkStatus = "nxlink: ";
-        _axologl->debug(nxlinkStatus + (_axologl->getNxlinkEnabled() ? "enabled" : "disabled"));
+        instance->debug(nxlinkStatus + (instance->getNxlinkEnabled() ? "enabled" : "disabled"));
         const std::string ansiStatus = "ANSI Output: ";
-        _axologl->debug(ansiStatus + (_ansi ? "enabled" : "disabled"));
-        if (_logfileEnabled)
+        instance->debug(ansiStatus + (_ansi ? "enabled" : "disabled"));
+        const std::string locationStatus = "Source locations: ";
+        instance->debug(locationStatus + (_sourceLocation ? (_shortSourcePaths ? "enabled (short paths)" : "enabled")
+                                                           : "disabled"));
+        const std::string sanitizeStatus = "Sanitized output: ";
+        instance->debug(sanitizeStatus + (_sanitizeConsole ? (_sanitizeFile ? "console, file" : "console")
+                                                           : (_sanitizeFile ? "file" : "none")));
+        if (_channel != nullptr)
+        {
+            instance->debug("Logging to file through a shared-memory channel");
+        }
+        else if (_logfileEnabled)
         {
-            _axologl->debug("Logging to file: " + _logPath);
+            instance->debug("Logging to file: " + _logPath + (_logfileCompressed ? " (compressed)" : "")
+                + (_logfileIndexed ? " (indexed)" : ""));
         }
         else
         {
-            _axologl->debug("Logging to file not enabled");
+            instance->debug("Logging to file not enabled");
         }
+
+        // Snapshot before printing so that these lines don't count themselves
+        const StatsSnapshot snapshot = stats();
+        static constexpr const char* levelNames[] = {"debug", "info", "notice", "warn", "error", "fatal", "raw"};
+        std::string messages = "Messages:";
+        std::string filtered = "Filtered:";
+        for (std::size_t i = 0; i < levelCount; i++)
+        {
+            messages += std::string(" ") + levelNames[i] + "=" + std::to_string(snapshot.messages[i]);
+            filtered += std::string(" ") + levelNames[i] + "=" + std::to_string(snapshot.filtered[i]);
+        }
+        instance->debug(messages);
+        instance->debug(filtered);
+        instance->debug("Bytes: file=" + std::to_string(snapshot.bytes[File])
+            + " stdout=" + std::to_string(snapshot.bytes[Stdout])
+            + " stderr=" + std::to_string(snapshot.bytes[Stderr]));
+        instance->debug("Drops: " + std::to_string(snapshot.drops) + " (console only: "
+            + std::to_string(snapshot.consoleDrops) + "), block writes: " + std::to_string(snapshot.blockWrites)
+            + ", syncs: " + std::to_string(snapshot.syncs));
+
+        const auto latency = [](const HistogramSnapshot& histogram) {
+            return std::to_string(histogram.percentile(0.5)) + "/" + std::to_string(histogram.percentile(0.99))
+                + "/" + std::to_string(histogram.percentile(0.999)) + " ns";
+        };
+        instance->debug("Log latency p50/p99/p999: " + latency(snapshot.logLatency));
+        instance->debug("File write latency p50/p99/p999: " + latency(snapshot.fileWriteLatency));
     }
 
     inline void enableAnsi()
@@ -218,12 +442,29 @@ namespace axologl
 
     inline void enableNxLink(const NxLinkOptions& opts)
     {
-        _axologl->enableNxLink(opts);
+        if (Axologl* const instance = _axologl.load(std::memory_order_acquire)) instance->enableNxLink(opts);
     }
 
     inline void disableNxLink()
     {
-        _axologl->disableNxLink();
+        if (Axologl* const instance = _axologl.load(std::memory_order_acquire)) instance->disableNxLink();
+    }
+
+    /**
+     * Show or hide the call site on records logged through the `AXOLOGL_<LEVEL>` macros
+     */
+    inline void setSourceLocation(const bool enabled)
+    {
+        _sourceLocation = enabled;
+    }
+
+    /**
+     * Choose which sinks get messages with control characters, escape sequences and invalid UTF-8 escaped
+     */
+    inline void setSanitize(const bool console, const bool file)
+    {
+        _sanitizeConsole = console;
+        _sanitizeFile = file;
     }
 
     inline void setLogLevel(const LogLevel level)
@@ -233,48 +474,63 @@ namespace axologl
 
     inline void setConsole(PrintConsole* console)
     {
-        _axologl->setConsole(console);
+        if (Axologl* const instance = _axologl.load(std::memory_order_acquire)) instance->setConsole(console);
     }
 
     /**
-     * Log a plain, unprefixed message
+     * Log a plain, unprefixed message. Like every logging function, this may be called before `configure()`; see
+     * `early.h`.
      *
      * @param text
      * @param color (Optional) An ANSI color code to colorize the message
      */
     inline void log(const std::string& text, const std::string* color = nullptr)
     {
-        _axologl->log(text, color);
+        Axologl* const instance = _axologl.load(std::memory_order_acquire);
+        if (instance == nullptr) return defer(Raw, text);
+        instance->log(text, color);
     }
 
-    inline void debug(const std::string& text)
+    inline void debug(const std::string& text, const SiteId site = noSite)
     {
-        _axologl->debug(text);
+        Axologl* const instance = _axologl.load(std::memory_order_acquire);
+        if (instance == nullptr) return defer(Debug, text, site);
+        instance->debug(text, site);
     }
 
-    inline void info(const std::string& text)
+    inline void info(const std::string& text, const SiteId site = noSite)
     {
-        _axologl->info(text);
+        Axologl* const instance = _axologl.load(std::memory_order_acquire);
+        if (instance == nullptr) return defer(Info, text, site);
+        instance->info(text, site);
     }
 
-    inline void notice(const std::string& text)
+    inline void notice(const std::string& text, const SiteId site = noSite)
     {
-        _axologl->notice(text);
+        Axologl* const instance = _axologl.load(std::memory_order_acquire);
+        if (instance == nullptr) return defer(Notice, text, site);
+        instance->notice(text, site);
     }
 
-    inline void warn(const std::string& text)
+    inline void warn(const std::string& text, const SiteId site = noSite)
     {
-        _axologl->warn(text);
+        Axologl* const instance = _axologl.load(std::memory_order_acquire);
+        if (instance == nullptr) return defer(Warning, text, site);
+        instance->warn(text, site);
     }
 
-    inline void error(const std::string& text)
+    inline void error(const std::string& text, const SiteId site = noSite)
     {
-        _axologl->error(text);
+        Axologl* const instance = _axologl.load(std::memory_order_acquire);
+        if (instance == nullptr) return defer(Error, text, site);
+        instance->error(text, site);
     }
 
-    inline void fatal(const std::string& text)
+    inline void fatal(const std::string& text, const SiteId site = noSite)
     {
-        _axologl->fatal(text);
+        Axologl* const instance = _axologl.load(std::memory_order_acquire);
+        if (instance == nullptr) return defer(Fatal, text, site);
+        instance->fatal(text, site);
     }
 
     /**
@@ -284,8 +540,10 @@ namespace axologl
      */
     inline void success(const std::string& text)
     {
+        Axologl* const instance = _axologl.load(std::memory_order_acquire);
+        if (instance == nullptr) return defer(Raw, text);
         const std::string green = "\033[32m";
-        _axologl->log(text, &green);
+        instance->log(text, &green);
     }
 
     /**
@@ -295,8 +553,10 @@ namespace axologl
      */
     inline void failure(const std::string& text)
     {
+        Axologl* const instance = _axologl.load(std::memory_order_acquire);
+        if (instance == nullptr) return defer(Raw, text);
         const std::string red = "\033[31m";
-        _axologl->log(text, &red);
+        instance->log(text, &red);
     }
 }
 #endif //AXOLOGL_AXOLOGL_H
@@ -0,0 +1,270 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_BATCH_H
+#define AXOLOGL_BATCH_H
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "axologl.h"
+
+namespace axologl
+{
+    /**
+     * Collects many records at one level and writes them in a single dispatch: one level and console check when the
+     * batch is created, one write and flush per sink on commit. The records reach each sink as one contiguous block,
+     * so records from other threads never land between them.
+     *
+     * ```
+     * axologl::Batch batch(axologl::Debug);
+     * for (const auto& entity : entities) batch.add(entity.describe());
+     * batch.commit();
+     * ```
+     *
+     * A batch that is filtered out by the log level does no formatting at all. Uncommitted records are written
+     * when the batch is destroyed. Records added while Axologl isn't configured are kept for replay one by one, like
+     * any other logging call, and so are records still in a batch when `teardown()` runs.
+     */
+    class Batch
+    {
+        // The instance `logger` belongs to; if it is no longer the configured one on commit, the records go elsewhere
+        Axologl* owner = nullptr;
+        Logger* logger = nullptr;
+        LogLevel level;
+        bool toConsole = false;
+        // Axologl wasn't configured when the batch was made; records are kept for replay instead (see `early.h`)
+        bool deferred = false;
+        std::size_t filtered = 0;
+        std::string fileText;
+        std::string consoleText;
+        // The messages as added, so that they can be laid out again by another instance
+        std::string messages;
+        // Where each record starts and ends in `fileText`, where its message ends in `messages`, and when it was added
+        struct Span
+        {
+            std::size_t begin;
+            std::size_t end;
+            std::size_t messageEnd;
+            std::uint64_t time;
+        };
+        std::vector<Span> records;
+        // Reused for messages that need escaping; see `sanitize.h`
+        std::string escaped;
+
+    public:
+        /**
+         * @param level         Level for every record in the batch
+         * @param reserveBytes  Expected size of the batch, to avoid regrowing the buffers
+         */
+        explicit Batch(const LogLevel level, const std::size_t reserveBytes = 4096) : level(level)
+        {
+            Axologl* const instance = _axologl.load(std::memory_order_acquire);
+            if (instance == nullptr)
+            {
+                // Held for replay like any other early record, unless the level filters it out
+                deferred = level >= _logLevel.load(std::memory_order_relaxed);
+                return;
+            }
+
+            Logger& candidate = instance->getLogger(level);
+            if (!candidate.shouldLog())
+            {
+                return;
+            }
+
+            owner = instance;
+            logger = &candidate;
+            toConsole = instance->canLogToConsole();
+            fileText.reserve(reserveBytes);
+            messages.reserve(reserveBytes);
+            if (toConsole) consoleText.reserve(reserveBytes + reserveBytes / 4);
+        }
+
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+
+        ~Batch()
+        {
+            commit();
+        }
+
+        /**
+         * Whether records added to this batch will be written; use it to skip building expensive messages
+         */
+        [[nodiscard]] bool enabled() const
+        {
+            return logger != nullptr || deferred;
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return records.size();
+        }
+
+        void add(const std::string& text)
+        {
+            if (deferred)
+            {
+                early::push(level, text);
+                return;
+            }
+            if (logger == nullptr)
+            {
+                filtered++;
+                return;
+            }
+
+            const Record record{level, text, noSite, wallClockMs(), currentThreadId()};
+            const bool showSource = _sourceLocation.load(std::memory_order_relaxed);
+            const bool shortPaths = _shortSourcePaths.load(std::memory_order_relaxed);
+            const bool sanitizeFile = _sanitizeFile.load(std::memory_order_relaxed);
+            const bool sanitizeConsole = toConsole && _sanitizeConsole.load(std::memory_order_relaxed);
+            Record safeRecord = record;
+            if ((sanitizeFile || sanitizeConsole) && sanitize::escape(text, escaped)) safeRecord.message = escaped;
+
+            if (!records.empty()) fileText.push_back('\n');
+            const std::size_t begin = fileText.size();
+            logger->fileLayout.render(sanitizeFile ? safeRecord : record, fileText, showSource, shortPaths);
+            messages.append(text);
+            records.push_back(Span{begin, fileText.size(), messages.size(), record.time});
+
+            if (toConsole)
+            {
+                if (!consoleText.empty()) consoleText.push_back('\n');
+                (_ansi ? logger->consoleAnsiLayout : logger->consoleLayout).render(
+                    sanitizeConsole ? safeRecord : record, consoleText, showSource, shortPaths);
+            }
+        }
+
+        /**
+         * Write every record added so far and start a new batch at the same level
+         */
+        void commit()
+        {
+            if (filtered != 0)
+            {
+                Stats::add(_stats.filtered[level], filtered);
+                filtered = 0;
+            }
+            if (records.empty())
+            {
+                return;
+            }
+
+            Axologl* const instance = _axologl.load(std::memory_order_acquire);
+            if (instance != owner)
+            {
+                // Torn down, and maybe configured again, since the batch was made
+                redirect(instance);
+                return;
+            }
+
+            const clock::Ticks start = clock::now();
+            std::uint64_t fileOffset = noFileOffset;
+            if (_channel != nullptr)
+            {
+                // Channel records are framed individually so that the collector can interleave producers by time
+                std::size_t dropped = 0;
+                for (const auto& [begin, end, messageEnd, time] : records)
+                {
+                    if (_channel->write(level, std::string_view(fileText).substr(begin, end - begin)))
+                    {
+                        Stats::add(_stats.bytes[File], end - begin + 1);
+                    }
+                    else
+                    {
+                        dropped++;
+                    }
+                }
+                if (dropped != 0)
+                {
+                    Stats::add(_stats.drops, dropped);
+                    Logger::pendingDrops.fetch_add(dropped, std::memory_order_relaxed);
+                }
+            }
+            else if (!logger->logToFile(fileText, logger->gate, fileOffset, records.front().time,
+                                        records.back().time))
+            {
+                // The level's overload policy gave up on the file; the batch is dropped as a whole, like one record
+                Stats::add(_stats.drops, records.size());
+                Logger::pendingDrops.fetch_add(records.size(), std::memory_order_relaxed);
+                clear();
+                return;
+            }
+
+            if (_tail != nullptr)
+            {
+                for (const auto& [begin, end, messageEnd, time] : records)
+                {
+                    _tail->publish(level, fileText.substr(begin, end - begin),
+                                   fileOffset == noFileOffset ? noFileOffset : fileOffset + begin, time);
+                }
+            }
+
+            if (toConsole && !Logger::logToConsole(consoleText, logger->gate))
+            {
+                Stats::add(_stats.consoleDrops, records.size());
+                Logger::pendingConsoleDrops.fetch_add(records.size(), std::memory_order_relaxed);
+            }
+
+            Stats::add(_stats.messages[level], records.size());
+            _stats.logLatency.recordTicks(start);
+            const std::uint64_t lastTime = records.back().time;
+            clear();
+
+            if (Logger::pendingDrops.load(std::memory_order_relaxed) != 0
+                || Logger::pendingConsoleDrops.load(std::memory_order_relaxed) != 0)
+            {
+                Logger::reportDrops(lastTime, toConsole);
+            }
+        }
+
+    private:
+        /**
+         * Log each record on its own through `instance`, or hold it for replay if there is none
+         */
+        void redirect(Axologl* const instance)
+        {
+            std::size_t messageBegin = 0;
+            for (const Span& record : records)
+            {
+                const std::string_view message(messages.data() + messageBegin, record.messageEnd - messageBegin);
+                messageBegin = record.messageEnd;
+                if (instance == nullptr)
+                {
+                    defer(level, message);
+                    continue;
+                }
+                instance->getLogger(level).log(Record{level, message, noSite, record.time, currentThreadId()},
+                                               instance->canLogToConsole());
+            }
+            clear();
+        }
+
+        void clear()
+        {
+            fileText.clear();
+            consoleText.clear();
+            messages.clear();
+            records.clear();
+        }
+    };
+}
+
+#endif //AXOLOGL_BATCH_H
@@ -0,0 +1,529 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_CHANNEL_H
+#define AXOLOGL_CHANNEL_H
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef __SWITCH__
+#include <switch.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "clock.h"
+#include "levels.h"
+
+/*
+ * Shared-memory log channel.
+ *
+ * Producer processes write records into a ring buffer in shared memory with nothing but atomics; one collector
+ * process drains the ring (or several rings) and writes a single time-ordered log. This keeps a single writer on
+ * the SD card when an application and its sysmodules all log.
+ *
+ * The region starts with a `ChannelHeader` followed by the ring. Records are 32-byte aligned and start with a
+ * `RecordHeader`; a producer reserves space by advancing `reserve` with a CAS, fills the record and then publishes
+ * it by setting its state. A record that would run off the end of the ring is preceded by a padding record. When the
+ * ring is full the record is dropped and counted rather than blocking the producer. A record left unpublished for
+ * longer than the collector's stall timeout, e.g. by a producer that died mid-write, is skipped and counted as dropped.
+ */
+namespace axologl
+{
+    namespace channel
+    {
+        inline constexpr char channelMagic[4] = {'A', 'X', 'C', 'H'};
+        inline constexpr std::uint32_t channelVersion = 1;
+        inline constexpr std::size_t recordAlignment = 32;
+
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "the channel needs address-free atomics");
+        static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "the channel needs address-free atomics");
+
+        enum RecordState : std::uint32_t
+        {
+            Empty = 0,
+            Committed = 1,
+            Padding = 2
+        };
+
+        struct ChannelHeader
+        {
+            char magic[4];
+            std::uint32_t version;
+            std::uint64_t capacity;
+            alignas(64) std::atomic<std::uint64_t> reserve;
+            alignas(64) std::atomic<std::uint64_t> consumed;
+            alignas(64) std::atomic<std::uint64_t> dropped;
+        };
+
+        struct RecordHeader
+        {
+            std::atomic<std::uint32_t> state;
+            // Stored right after the slot is reserved, so a producer that dies later still leaves it skippable
+            std::atomic<std::uint32_t> size;
+            std::uint64_t time;
+            std::uint32_t source;
+            std::uint16_t length;
+            std::uint8_t level;
+            std::uint8_t reserved;
+        };
+
+        static_assert(sizeof(RecordHeader) <= recordAlignment);
+
+        inline constexpr std::size_t dataOffset = (sizeof(ChannelHeader) + 63) & ~std::size_t{63};
+
+        constexpr std::size_t alignRecord(const std::size_t size)
+        {
+            return (size + recordAlignment - 1) & ~(recordAlignment - 1);
+        }
+    }
+
+    /**
+     * @struct ChannelRecord
+     *
+     * @brief A record read back out of a `SharedChannel`
+     *
+     * @param time      When the producer logged it, in `clock` ticks (comparable across processes)
+     * @param source    The producer's source id
+     * @param level     The level it was logged at
+     * @param text      The formatted record, without a trailing newline
+     * @param formatted Whether `text` is laid out already; the collector's own notices are bare messages
+     */
+    struct ChannelRecord
+    {
+        clock::Ticks time = 0;
+        std::uint32_t source = 0;
+        LogLevel level = Raw;
+        std::string text;
+        bool formatted = true;
+    };
+
+    /**
+     * One shared-memory ring. The creating process owns the region; other processes attach to it.
+     */
+    class SharedChannel
+    {
+        void* region = nullptr;
+        std::size_t regionSize = 0;
+        std::uint32_t source = 0;
+        bool owner = false;
+        // Collector side: the unpublished record `drain()` is waiting on, and since when
+        std::uint64_t stalledAt = UINT64_MAX;
+        clock::Ticks stalledSince = 0;
+        clock::Ticks stallTimeout = clock::fromNs(1000000000);
+#ifdef __SWITCH__
+        SharedMemory sharedMemory{};
+#else
+        std::string name;
+#endif
+
+        [[nodiscard]] channel::ChannelHeader& header() const
+        {
+            return *static_cast<channel::ChannelHeader*>(region);
+        }
+
+        [[nodiscard]] char* data() const
+        {
+            return static_cast<char*>(region) + channel::dataOffset;
+        }
+
+        [[nodiscard]] channel::RecordHeader& recordAt(const std::uint64_t position) const
+        {
+            return *reinterpret_cast<channel::RecordHeader*>(data() + (position & (header().capacity - 1)));
+        }
+
+        static std::size_t regionSizeFor(const std::size_t capacity)
+        {
+            // Shared memory is handed out in whole pages
+            return (channel::dataOffset + capacity + 0xFFF) & ~std::size_t{0xFFF};
+        }
+
+        static std::size_t roundCapacity(const std::size_t requested)
+        {
+            std::size_t capacity = 4096;
+            while (capacity < requested) capacity <<= 1;
+            return capacity;
+        }
+
+        void initialise(const std::size_t capacity)
+        {
+            std::memset(region, 0, regionSize);
+            auto* h = new (region) channel::ChannelHeader{};
+            std::memcpy(h->magic, channel::channelMagic, sizeof(h->magic));
+            h->version = channel::channelVersion;
+            h->capacity = capacity;
+        }
+
+        [[nodiscard]] bool validate() const
+        {
+            const channel::ChannelHeader& h = header();
+            return std::memcmp(h.magic, channel::channelMagic, sizeof(h.magic)) == 0
+                && h.version == channel::channelVersion
+                && h.capacity != 0 && (h.capacity & (h.capacity - 1)) == 0
+                && channel::dataOffset + h.capacity <= regionSize;
+        }
+
+    public:
+#ifdef __SWITCH__
+        /**
+         * Create a new channel. Send `getHandle()` to the other processes over your own IPC so they can attach.
+         *
+         * @param capacity Size of the ring in bytes, rounded up to a power of two
+         */
+        explicit SharedChannel(const std::size_t capacity) : owner(true)
+        {
+            const std::size_t ringSize = roundCapacity(capacity);
+            regionSize = regionSizeFor(ringSize);
+            if (R_SUCCEEDED(shmemCreate(&sharedMemory, regionSize, Perm_Rw, Perm_Rw))
+                && R_SUCCEEDED(shmemMap(&sharedMemory)))
+            {
+                region = shmemGetAddr(&sharedMemory);
+                initialise(ringSize);
+            }
+        }
+
+        /**
+         * Attach to a channel created by another process
+         *
+         * @param handle    The handle the creating process shared
+         * @param capacity  The capacity it was created with
+         */
+        SharedChannel(const Handle handle, const std::size_t capacity)
+        {
+            regionSize = regionSizeFor(roundCapacity(capacity));
+            shmemLoadRemote(&sharedMemory, handle, regionSize, Perm_Rw);
+            if (R_SUCCEEDED(shmemMap(&sharedMemory)))
+            {
+                region = shmemGetAddr(&sharedMemory);
+                if (!validate())
+                {
+                    shmemUnmap(&sharedMemory);
+                    region = nullptr;
+                }
+            }
+        }
+
+        ~SharedChannel()
+        {
+            if (region != nullptr) shmemUnmap(&sharedMemory);
+            shmemClose(&sharedMemory);
+        }
+
+        [[nodiscard]] Handle getHandle() const
+        {
+            return sharedMemory.handle;
+        }
+#else
+        /**
+         * Create a new POSIX shared-memory channel
+         *
+         * @param name      Name passed to `shm_open`, e.g. "/axologl"
+         * @param capacity  Size of the ring in bytes, rounded up to a power of two
+         */
+        SharedChannel(const char* name, const std::size_t capacity) : owner(true), name(name)
+        {
+            const std::size_t ringSize = roundCapacity(capacity);
+            regionSize = regionSizeFor(ringSize);
+            const int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0600);
+            if (fd < 0) return;
+            if (ftruncate(fd, static_cast<off_t>(regionSize)) == 0)
+            {
+                void* mapped = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (mapped != MAP_FAILED)
+                {
+                    region = mapped;
+                    initialise(ringSize);
+                }
+            }
+            close(fd);
+        }
+
+        /**
+         * Attach to a channel created by another process
+         *
+         * @param name Name the creating process used
+         */
+        explicit SharedChannel(const char* name)
+        {
+            const int fd = shm_open(name, O_RDWR, 0600);
+            if (fd < 0) return;
+            const off_t size = lseek(fd, 0, SEEK_END);
+            if (size > 0)
+            {
+                regionSize = static_cast<std::size_t>(size);
+                void* mapped = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (mapped != MAP_FAILED)
+                {
+                    region = mapped;
+                    if (!validate())
+                    {
+                        munmap(region, regionSize);
+                        region = nullptr;
+                    }
+                }
+            }
+            close(fd);
+        }
+
+        ~SharedChannel()
+        {
+            if (region != nullptr) munmap(region, regionSize);
+            if (owner) shm_unlink(name.c_str());
+        }
+#endif
+
+        SharedChannel(const SharedChannel&) = delete;
+        SharedChannel& operator=(const SharedChannel&) = delete;
+
+        [[nodiscard]] bool ready() const
+        {
+            return region != nullptr;
+        }
+
+        /**
+         * Tag every record this process writes, so that the collector can tell producers apart
+         */
+        void setSource(const std::uint32_t id)
+        {
+            source = id;
+        }
+
+        /**
+         * How long `drain()` waits on a reserved record that hasn't been published before skipping it. A producer still
+         * writing after this would overwrite newer records, so it should be well above any preemption.
+         */
+        void setStallTimeout(const std::chrono::milliseconds timeout)
+        {
+            stallTimeout = clock::fromNs(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count());
+        }
+
+        /**
+         * @return Records producers could not fit into the ring, or that were skipped as stalled
+         */
+        [[nodiscard]] std::uint64_t getDropped() const
+        {
+            return header().dropped.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Write a record without any syscall or lock. Text longer than a quarter of the ring is truncated.
+         *
+         * @return false if the ring was full and the record was dropped
+         */
+        bool write(const LogLevel level, const std::string_view text)
+        {
+            using namespace channel;
+            ChannelHeader& h = header();
+            const std::size_t length = std::min<std::size_t>({text.size(), h.capacity / 4, UINT16_MAX});
+            const std::size_t size = alignRecord(sizeof(RecordHeader) + length);
+            const clock::Ticks time = clock::now();
+
+            std::uint64_t position = h.reserve.load(std::memory_order_relaxed);
+            std::size_t padding;
+            do
+            {
+                const std::size_t untilEnd = h.capacity - (position & (h.capacity - 1));
+                padding = untilEnd < size ? untilEnd : 0;
+                if (position + padding + size - h.consumed.load(std::memory_order_acquire) > h.capacity)
+                {
+                    h.dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            } while (!h.reserve.compare_exchange_weak(position, position + padding + size, std::memory_order_relaxed));
+
+            if (padding != 0)
+            {
+                RecordHeader& pad = recordAt(position);
+                pad.size.store(static_cast<std::uint32_t>(padding), std::memory_order_relaxed);
+                pad.state.store(Padding, std::memory_order_release);
+                position += padding;
+            }
+
+            RecordHeader& record = recordAt(position);
+            record.size.store(static_cast<std::uint32_t>(size), std::memory_order_relaxed);
+            record.time = time;
+            record.source = source;
+            record.length = static_cast<std::uint16_t>(length);
+            record.level = static_cast<std::uint8_t>(level);
+            std::memcpy(reinterpret_cast<char*>(&record) + sizeof(RecordHeader), text.data(), length);
+            record.state.store(Committed, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Move every published record into `out`, in ring order. Only the collector may call this.
+         *
+         * @return The number of records read
+         */
+        std::size_t drain(std::vector<ChannelRecord>& out)
+        {
+            using namespace channel;
+            ChannelHeader& h = header();
+            std::uint64_t position = h.consumed.load(std::memory_order_relaxed);
+            const std::uint64_t end = h.reserve.load(std::memory_order_acquire);
+            std::size_t count = 0;
+
+            while (position < end)
+            {
+                RecordHeader& record = recordAt(position);
+                const std::uint32_t state = record.state.load(std::memory_order_acquire);
+
+                // Later records may already be published, but ring order is kept by waiting for this one
+                if (state == Empty && !stalled(position)) break;
+
+                std::uint32_t size = record.size.load(std::memory_order_relaxed);
+                if (state == Empty)
+                {
+                    // Its producer stopped before publishing. With no size stored it wrote nothing at all, so its
+                    // slot reads as zeroes up to the next header.
+                    if (size == 0) size = zeroedSpan(position, end);
+                    h.dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (state == Committed)
+                {
+                    ChannelRecord copy;
+                    copy.time = record.time;
+                    copy.source = record.source;
+                    copy.level = static_cast<LogLevel>(record.level);
+                    copy.text.assign(reinterpret_cast<const char*>(&record) + sizeof(RecordHeader), record.length);
+                    out.push_back(std::move(copy));
+                    count++;
+                }
+
+                // Producers may place a header anywhere in this span next time round, so it must read as empty.
+                // Nobody else touches it until `consumed` moves past it.
+                std::memset(static_cast<void*>(&record), 0, size);
+                position += size;
+            }
+
+            h.consumed.store(position, std::memory_order_release);
+            return count;
+        }
+
+    private:
+        /**
+         * @return Whether the unpublished record at `position` has been waited on for longer than the stall timeout
+         */
+        bool stalled(const std::uint64_t position)
+        {
+            const clock::Ticks now = clock::now();
+            if (position != stalledAt)
+            {
+                stalledAt = position;
+                stalledSince = now;
+                return false;
+            }
+            return now - stalledSince >= stallTimeout;
+        }
+
+        /**
+         * @return How many bytes from `position` are zero-filled record slots, stopping at the next header with a size
+         */
+        std::uint32_t zeroedSpan(const std::uint64_t position, const std::uint64_t end) const
+        {
+            using namespace channel;
+            std::uint64_t next = position + recordAlignment;
+            while (next < end && recordAt(next).size.load(std::memory_order_relaxed) == 0)
+            {
+                next += recordAlignment;
+            }
+            return static_cast<std::uint32_t>(next - position);
+        }
+    };
+
+    /**
+     * Merges one or more channels into a single time-ordered stream. Records are held back for a short reordering
+     * window, because a producer can be preempted between taking its timestamp and reserving its slot.
+     */
+    class ChannelCollector
+    {
+        std::vector<SharedChannel*> channels;
+        std::vector<ChannelRecord> pending;
+        std::vector<std::uint64_t> reportedDrops;
+        clock::Ticks window;
+
+    public:
+        explicit ChannelCollector(const std::chrono::milliseconds reorderWindow = std::chrono::milliseconds(50))
+            : window(clock::fromNs(std::chrono::duration_cast<std::chrono::nanoseconds>(reorderWindow).count()))
+        {
+        }
+
+        void addChannel(SharedChannel* channel)
+        {
+            channels.push_back(channel);
+            reportedDrops.push_back(0);
+        }
+
+        /**
+         * Drain every channel and hand the records that are older than the reordering window to `sink`
+         * (`void(const ChannelRecord&)`), oldest first. Call this regularly, e.g. once per frame.
+         * `axologl::logCollected` is a sink that writes them to the collector's own log.
+         *
+         * @param flushAll Also hand over the records still inside the window, e.g. at shutdown
+         *
+         * @return The number of records handed to `sink`
+         */
+        template <typename Sink>
+        std::size_t collect(Sink&& sink, const bool flushAll = false)
+        {
+            for (std::size_t i = 0; i < channels.size(); i++)
+            {
+                channels[i]->drain(pending);
+
+                const std::uint64_t dropped = channels[i]->getDropped();
+                if (dropped != reportedDrops[i])
+                {
+                    ChannelRecord notice;
+                    notice.time = clock::now();
+                    notice.level = Warning;
+                    notice.text = std::to_string(dropped - reportedDrops[i])
+                        + " records dropped by a full or stalled channel";
+                    notice.formatted = false;
+                    pending.push_back(std::move(notice));
+                    reportedDrops[i] = dropped;
+                }
+            }
+
+            std::stable_sort(pending.begin(), pending.end(), [](const ChannelRecord& a, const ChannelRecord& b) {
+                return a.time < b.time;
+            });
+
+            const clock::Ticks now = clock::now();
+            const clock::Ticks cutoff = now > window ? now - window : 0;
+            std::size_t ready = 0;
+            while (ready < pending.size() && (flushAll || pending[ready].time <= cutoff))
+            {
+                sink(static_cast<const ChannelRecord&>(pending[ready]));
+                ready++;
+            }
+            pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(ready));
+            return ready;
+        }
+    };
+}
+
+#endif //AXOLOGL_CHANNEL_H
@@ -0,0 +1,65 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_CLOCK_H
+#define AXOLOGL_CLOCK_H
+#include <chrono>
+#include <cstdint>
+
+#ifdef __SWITCH__
+#include <switch.h>
+#endif
+
+namespace axologl::clock
+{
+    using Ticks = std::uint64_t;
+
+    /**
+     * Reads the cheapest monotonic clock available; on the Switch this is the system counter register, so no syscall
+     * is involved
+     */
+    inline Ticks now()
+    {
+#ifdef __SWITCH__
+        return armGetSystemTick();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    inline std::uint64_t toNs(const Ticks ticks)
+    {
+#ifdef __SWITCH__
+        return armTicksToNs(ticks);
+#else
+        return ticks;
+#endif
+    }
+
+    inline Ticks fromNs(const std::uint64_t ns)
+    {
+#ifdef __SWITCH__
+        return armNsToTicks(ns);
+#else
+        return ns;
+#endif
+    }
+}
+
+#endif //AXOLOGL_CLOCK_H
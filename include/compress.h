@@ -0,0 +1,586 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_COMPRESS_H
+#define AXOLOGL_COMPRESS_H
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Block compression for the log file.
+ *
+ * Blocks use the LZ4 sequence layout (token, literals, 16-bit offset, match length) and are wrapped in a small
+ * self-delimiting frame so that a file cut short by a crash still decodes up to its last complete block. A crash
+ * leaves its partial block in the middle of the file once the next session appends after it; readers skip such
+ * damage by searching for the next session header:
+ *
+ *     file   := session*
+ *     session:= "AXLZ" version(u8) reserved(u8[3]) block*
+ *     block  := storedSize(u32) rawSize(u32) adler32(u32) payload
+ *
+ * All integers are little-endian. The top bit of `storedSize` marks a block that was stored uncompressed.
+ *
+ * This header deliberately has no libnx dependency so that it can be used by the host tools.
+ */
+namespace axologl::compress
+{
+    inline constexpr std::size_t maxBlockSize = 64 * 1024;
+
+    inline constexpr char frameMagic[4] = {'A', 'X', 'L', 'Z'};
+    inline constexpr std::uint8_t frameVersion = 1;
+    inline constexpr std::size_t frameHeaderSize = 8;
+    inline constexpr std::size_t blockHeaderSize = 12;
+    inline constexpr std::uint32_t storedFlag = 0x80000000u;
+
+    /**
+     * The worst-case size of a compressed block, used to size output buffers
+     */
+    constexpr std::size_t compressBound(const std::size_t size)
+    {
+        return size + size / 255 + 16;
+    }
+
+    namespace detail
+    {
+        static constexpr std::size_t minMatch = 4;
+        static constexpr std::size_t lastLiterals = 5;
+        static constexpr std::size_t matchLimit = 12;
+        static constexpr std::size_t hashLog = 12;
+
+        inline std::uint32_t read32(const char* p)
+        {
+            std::uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        inline std::uint64_t read64(const char* p)
+        {
+            std::uint64_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        inline void writeLE32(char* p, const std::uint32_t value)
+        {
+            p[0] = static_cast<char>(value & 0xFF);
+            p[1] = static_cast<char>((value >> 8) & 0xFF);
+            p[2] = static_cast<char>((value >> 16) & 0xFF);
+            p[3] = static_cast<char>((value >> 24) & 0xFF);
+        }
+
+        inline std::uint32_t readLE32(const char* p)
+        {
+            const auto* u = reinterpret_cast<const unsigned char*>(p);
+            return static_cast<std::uint32_t>(u[0])
+                | static_cast<std::uint32_t>(u[1]) << 8
+                | static_cast<std::uint32_t>(u[2]) << 16
+                | static_cast<std::uint32_t>(u[3]) << 24;
+        }
+
+        inline std::uint32_t hash(const std::uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - hashLog);
+        }
+
+        inline char* writeLength(char* op, std::size_t length)
+        {
+            while (length >= 255)
+            {
+                *op++ = static_cast<char>(255);
+                length -= 255;
+            }
+            *op++ = static_cast<char>(length);
+            return op;
+        }
+
+        /**
+         * Counts how many bytes match between `ip` and `ref`, stopping at `limit`
+         */
+        inline const char* extendMatch(const char* ip, const char* ref, const char* limit)
+        {
+            while (ip + sizeof(std::uint64_t) <= limit)
+            {
+                const std::uint64_t diff = read64(ip) ^ read64(ref);
+                if (diff != 0)
+                {
+                    return ip + (__builtin_ctzll(diff) >> 3);
+                }
+                ip += sizeof(std::uint64_t);
+                ref += sizeof(std::uint64_t);
+            }
+            while (ip < limit && *ip == *ref)
+            {
+                ip++;
+                ref++;
+            }
+            return ip;
+        }
+    }
+
+    /**
+     * Adler-32 checksum, used to detect blocks that were only partially written
+     */
+    inline std::uint32_t checksum(const char* data, std::size_t size)
+    {
+        // Largest run of bytes that cannot overflow the 32-bit sums before reducing
+        static constexpr std::size_t nmax = 5552;
+        std::uint32_t a = 1;
+        std::uint32_t b = 0;
+        const auto* p = reinterpret_cast<const unsigned char*>(data);
+        while (size > 0)
+        {
+            std::size_t run = size < nmax ? size : nmax;
+            size -= run;
+            while (run--)
+            {
+                a += *p++;
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+        }
+        return (b << 16) | a;
+    }
+
+    class BlockCompressor
+    {
+        std::array<std::uint32_t, 1 << detail::hashLog> table{};
+
+    public:
+        /**
+         * Compress a single block
+         *
+         * @param src           Block to compress; at most `maxBlockSize` bytes
+         * @param srcSize       Size of the block
+         * @param dst           Output buffer
+         * @param dstCapacity   Size of `dst`; must be at least `compressBound(srcSize)`
+         *
+         * @return The compressed size, or 0 if the arguments were out of range
+         */
+        std::size_t compress(const char* src, const std::size_t srcSize, char* dst, const std::size_t dstCapacity)
+        {
+            using namespace detail;
+
+            if (srcSize > maxBlockSize || dstCapacity < compressBound(srcSize))
+            {
+                return 0;
+            }
+
+            const char* ip = src;
+            const char* anchor = src;
+            const char* const iend = src + srcSize;
+            char* op = dst;
+
+            if (srcSize > matchLimit)
+            {
+                const char* const mflimit = iend - matchLimit;
+                const char* const matchEnd = iend - lastLiterals;
+                std::uint32_t misses = 0;
+
+                table.fill(0);
+                ip++;
+
+                while (ip < mflimit)
+                {
+                    const std::uint32_t sequence = read32(ip);
+                    const std::uint32_t h = hash(sequence);
+                    const char* ref = src + table[h];
+                    table[h] = static_cast<std::uint32_t>(ip - src);
+
+                    if (ref >= ip || read32(ref) != sequence)
+                    {
+                        // Skip faster through data that is not compressing
+                        ip += 1 + (misses++ >> 6);
+                        continue;
+                    }
+                    misses = 0;
+
+                    while (ip > anchor && ref > src && ip[-1] == ref[-1])
+                    {
+                        ip--;
+                        ref--;
+                    }
+
+                    const char* matchStop = extendMatch(ip + minMatch, ref + minMatch, matchEnd);
+                    const std::size_t literalLength = ip - anchor;
+                    const std::size_t matchLength = matchStop - ip - minMatch;
+                    const std::size_t offset = ip - ref;
+
+                    char* token = op++;
+                    *token = static_cast<char>(((literalLength >= 15 ? 15 : literalLength) << 4)
+                        | (matchLength >= 15 ? 15 : matchLength));
+                    if (literalLength >= 15) op = writeLength(op, literalLength - 15);
+                    std::memcpy(op, anchor, literalLength);
+                    op += literalLength;
+                    *op++ = static_cast<char>(offset & 0xFF);
+                    *op++ = static_cast<char>(offset >> 8);
+                    if (matchLength >= 15) op = writeLength(op, matchLength - 15);
+
+                    ip = matchStop;
+                    anchor = ip;
+                    if (ip < mflimit)
+                    {
+                        table[hash(read32(ip - 2))] = static_cast<std::uint32_t>(ip - 2 - src);
+                    }
+                }
+            }
+
+            const std::size_t literalLength = iend - anchor;
+            *op++ = static_cast<char>((literalLength >= 15 ? 15 : literalLength) << 4);
+            if (literalLength >= 15) op = detail::writeLength(op, literalLength - 15);
+            std::memcpy(op, anchor, literalLength);
+            op += literalLength;
+
+            return op - dst;
+        }
+    };
+
+    /**
+     * Decompress a single block, validating every length and offset against the buffers
+     *
+     * @param src           Compressed block
+     * @param srcSize       Size of the compressed block
+     * @param dst           Output buffer
+     * @param dstCapacity   Size of `dst`
+     * @param written       Set to the number of bytes decompressed
+     *
+     * @return Whether the block was well-formed
+     */
+    inline bool decompress(const char* src, const std::size_t srcSize, char* dst, const std::size_t dstCapacity,
+                           std::size_t& written)
+    {
+        const auto* ip = reinterpret_cast<const unsigned char*>(src);
+        const auto* const iend = ip + srcSize;
+        char* op = dst;
+        char* const oend = dst + dstCapacity;
+
+        const auto readLength = [&](std::size_t& length) {
+            unsigned char b;
+            do
+            {
+                if (ip >= iend) return false;
+                b = *ip++;
+                length += b;
+            } while (b == 255);
+            return true;
+        };
+
+        while (ip < iend)
+        {
+            const unsigned char token = *ip++;
+
+            std::size_t literalLength = token >> 4;
+            if (literalLength == 15 && !readLength(literalLength)) return false;
+            if (literalLength > static_cast<std::size_t>(iend - ip)
+                || literalLength > static_cast<std::size_t>(oend - op))
+            {
+                return false;
+            }
+            std::memcpy(op, ip, literalLength);
+            op += literalLength;
+            ip += literalLength;
+
+            // The final sequence carries literals only
+            if (ip == iend) break;
+
+            if (iend - ip < 2) return false;
+            const std::size_t offset = ip[0] | static_cast<std::size_t>(ip[1]) << 8;
+            ip += 2;
+            if (offset == 0 || offset > static_cast<std::size_t>(op - dst)) return false;
+
+            std::size_t matchLength = token & 0x0F;
+            if (matchLength == 15 && !readLength(matchLength)) return false;
+            matchLength += detail::minMatch;
+            if (matchLength > static_cast<std::size_t>(oend - op)) return false;
+
+            const char* match = op - offset;
+            if (offset >= matchLength)
+            {
+                std::memcpy(op, match, matchLength);
+            }
+            else
+            {
+                // Overlapping copy repeats the last `offset` bytes
+                for (std::size_t i = 0; i < matchLength; i++)
+                {
+                    op[i] = match[i];
+                }
+            }
+            op += matchLength;
+        }
+
+        written = op - dst;
+        return true;
+    }
+
+    /**
+     * Turns raw log text into framed blocks ready to be appended to a file
+     */
+    class FrameEncoder
+    {
+        BlockCompressor compressor;
+        std::vector<char> frame = std::vector<char>(blockHeaderSize + compressBound(maxBlockSize));
+
+    public:
+        /**
+         * @return The header that starts every session in a compressed log file
+         */
+        static std::string_view header()
+        {
+            static constexpr char bytes[frameHeaderSize] = {
+                frameMagic[0], frameMagic[1], frameMagic[2], frameMagic[3], static_cast<char>(frameVersion), 0, 0, 0
+            };
+            return {bytes, frameHeaderSize};
+        }
+
+        /**
+         * Encode one block of at most `maxBlockSize` bytes. Blocks that do not shrink are stored as-is.
+         *
+         * @return The encoded block, valid until the next call
+         */
+        std::string_view encode(const char* raw, const std::size_t rawSize)
+        {
+            char* payload = frame.data() + blockHeaderSize;
+            std::size_t storedSize = compressor.compress(raw, rawSize, payload, frame.size() - blockHeaderSize);
+            std::uint32_t sizeField = static_cast<std::uint32_t>(storedSize);
+            if (storedSize == 0 || storedSize >= rawSize)
+            {
+                std::memcpy(payload, raw, rawSize);
+                storedSize = rawSize;
+                sizeField = static_cast<std::uint32_t>(rawSize) | storedFlag;
+            }
+
+            detail::writeLE32(frame.data(), sizeField);
+            detail::writeLE32(frame.data() + 4, static_cast<std::uint32_t>(rawSize));
+            detail::writeLE32(frame.data() + 8, checksum(raw, rawSize));
+            return {frame.data(), blockHeaderSize + storedSize};
+        }
+    };
+
+    /**
+     * Reads a compressed log file back block by block
+     */
+    class FrameReader
+    {
+        enum class Read
+        {
+            Block,
+            Session,
+            End,
+            Damaged
+        };
+
+        FILE* file;
+        std::vector<char> stored = std::vector<char>(compressBound(maxBlockSize));
+        long offset = 0;
+        bool _truncated = false;
+        std::size_t _damagedRegions = 0;
+        std::uint64_t _damagedBytes = 0;
+
+        bool readExactly(char* out, const std::size_t size)
+        {
+            return fread(out, 1, size, file) == size;
+        }
+
+        /**
+         * Decode whatever starts at the current file position: a block into `out`, or a session header
+         */
+        Read decode(std::string& out)
+        {
+            char header[blockHeaderSize];
+            const std::size_t got = fread(header, 1, 4, file);
+            if (got == 0)
+            {
+                return Read::End;
+            }
+            if (got < 4)
+            {
+                return Read::Damaged;
+            }
+
+            if (std::memcmp(header, frameMagic, sizeof(frameMagic)) == 0)
+            {
+                // A new session started; only the version matters to us
+                return readExactly(header + 4, frameHeaderSize - 4)
+                    && static_cast<std::uint8_t>(header[4]) <= frameVersion ? Read::Session : Read::Damaged;
+            }
+
+            if (!readExactly(header + 4, blockHeaderSize - 4))
+            {
+                return Read::Damaged;
+            }
+
+            const std::uint32_t sizeField = detail::readLE32(header);
+            const bool isStored = (sizeField & storedFlag) != 0;
+            const std::size_t storedSize = sizeField & ~storedFlag;
+            const std::size_t rawSize = detail::readLE32(header + 4);
+            const std::uint32_t expected = detail::readLE32(header + 8);
+
+            // Zero-filled tails are what a power cut usually leaves behind
+            if (rawSize == 0 || rawSize > maxBlockSize || storedSize > stored.size()
+                || (isStored && storedSize != rawSize)
+                || !readExactly(stored.data(), storedSize))
+            {
+                return Read::Damaged;
+            }
+
+            out.resize(rawSize);
+            std::size_t written = rawSize;
+            if (isStored)
+            {
+                std::memcpy(out.data(), stored.data(), rawSize);
+            }
+            else if (!decompress(stored.data(), storedSize, out.data(), rawSize, written) || written != rawSize)
+            {
+                return Read::Damaged;
+            }
+
+            return checksum(out.data(), rawSize) == expected ? Read::Block : Read::Damaged;
+        }
+
+        /**
+         * Move past the damaged block at `offset` to the next session header
+         *
+         * @return false if there is none, i.e. the damage runs to the end of the file
+         */
+        bool skipDamage()
+        {
+            _damagedRegions++;
+            long position = offset + 1;
+            if (fseek(file, position, SEEK_SET) != 0)
+            {
+                _truncated = true;
+                return false;
+            }
+
+            // The magic can straddle two reads, so the last few bytes of each are searched again with the next
+            constexpr std::size_t overlap = sizeof(frameMagic) - 1;
+            char buffer[4096];
+            std::size_t kept = 0;
+            for (;;)
+            {
+                const std::size_t got = fread(buffer + kept, 1, sizeof(buffer) - kept, file);
+                const std::string_view window(buffer, kept + got);
+                const std::size_t found = window.find(std::string_view(frameMagic, sizeof(frameMagic)));
+                if (found != std::string_view::npos)
+                {
+                    const long session = position + static_cast<long>(found);
+                    _damagedBytes += session - offset;
+                    fseek(file, session, SEEK_SET);
+                    return true;
+                }
+                if (got == 0)
+                {
+                    _damagedBytes += position + static_cast<long>(window.size()) - offset;
+                    _truncated = true;
+                    return false;
+                }
+
+                kept = window.size() < overlap ? window.size() : overlap;
+                std::memmove(buffer, buffer + window.size() - kept, kept);
+                position += static_cast<long>(window.size() - kept);
+            }
+        }
+
+    public:
+        explicit FrameReader(FILE* file) : file(file)
+        {
+            if (file != nullptr)
+            {
+                offset = ftell(file);
+            }
+        }
+
+        /**
+         * Decompress the next block into `out`. A block that is incomplete or corrupt, such as one cut short by a
+         * crash before the next session was appended, is skipped along with everything up to the next session.
+         *
+         * @return false at the end of the file
+         */
+        bool next(std::string& out)
+        {
+            while (file != nullptr)
+            {
+                offset = ftell(file);
+                const Read read = decode(out);
+                if (read == Read::Block)
+                {
+                    return true;
+                }
+                if (read == Read::End || (read == Read::Damaged && !skipDamage()))
+                {
+                    break;
+                }
+            }
+
+            out.clear();
+            return false;
+        }
+
+        /**
+         * Decompress the block that starts at the current file position into `out`, without skipping anything
+         *
+         * @return false if there is no intact block there
+         */
+        bool readBlock(std::string& out)
+        {
+            offset = ftell(file);
+            return decode(out) == Read::Block;
+        }
+
+        /**
+         * @return Whether the file ends in an incomplete or corrupt block rather than a clean end of file
+         */
+        [[nodiscard]] bool truncated() const
+        {
+            return _truncated;
+        }
+
+        /**
+         * @return How many stretches of damaged data were skipped
+         */
+        [[nodiscard]] std::size_t damagedRegions() const
+        {
+            return _damagedRegions;
+        }
+
+        /**
+         * @return How many bytes were skipped as damaged in total
+         */
+        [[nodiscard]] std::uint64_t damagedBytes() const
+        {
+            return _damagedBytes;
+        }
+
+        /**
+         * @return The file offset of the block most recently returned by `next()`
+         */
+        [[nodiscard]] long blockOffset() const
+        {
+            return offset;
+        }
+    };
+}
+
+#endif //AXOLOGL_COMPRESS_H
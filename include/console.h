@@ -0,0 +1,159 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_CONSOLE_H
+#define AXOLOGL_CONSOLE_H
+#include <condition_variable>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "overload.h"
+
+namespace axologl
+{
+    /**
+     * Writes console lines to stdout and stderr from a thread of its own, for `AxologlOptions::asyncConsole`. The
+     * console can be far slower than the code logging to it (the libnx console redraws, nxlink goes over the
+     * network), so lines are queued and a logging thread only waits, subject to its overload policy, once
+     * `capacity` bytes are queued. Lines from different threads never interleave.
+     *
+     * The price is that the console is written from another thread than the app's own. On the Switch that thread
+     * races with the main thread's `consoleUpdate()` and any text the app prints itself, and log lines can land out
+     * of order with it, which is why this is opt-in.
+     */
+    class ConsoleWriter
+    {
+        static constexpr std::size_t capacity = 16 * 1024;
+
+        static void writeAll(const int fd, const char* data, std::size_t size)
+        {
+            while (size > 0)
+            {
+                const ssize_t written = ::write(fd, data, size);
+                if (written <= 0) return;
+                data += written;
+                size -= written;
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable drained;
+        std::string queued;
+        // Only touched by the writer thread
+        std::string writing;
+        bool busy = false;
+        bool stopping = false;
+        std::thread writer;
+
+        void run()
+        {
+            std::unique_lock lock(mutex);
+            for (;;)
+            {
+                wake.wait(lock, [this] { return !queued.empty() || stopping; });
+                if (queued.empty()) break;
+
+                queued.swap(writing);
+                busy = true;
+                // Room was made, so waiting loggers can go ahead while this is written
+                drained.notify_all();
+                lock.unlock();
+
+                std::cout << writing << std::flush;
+                std::cerr << writing << std::flush;
+                writing.clear();
+
+                lock.lock();
+                busy = false;
+                drained.notify_all();
+            }
+        }
+
+    public:
+        ConsoleWriter() = default;
+        ConsoleWriter(const ConsoleWriter&) = delete;
+        ConsoleWriter& operator=(const ConsoleWriter&) = delete;
+
+        ~ConsoleWriter()
+        {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            if (writer.joinable()) writer.join();
+        }
+
+        /**
+         * Queue `text` as a line, waiting for room only as long as `gate`'s overload policy allows
+         *
+         * @return Whether the line was queued
+         */
+        bool write(const std::string& text, OverloadGate& gate)
+        {
+            std::unique_lock lock = gate.enter(mutex);
+            if (!lock.owns_lock()) return false;
+
+            // A line bigger than the whole queue still goes in once the queue is empty
+            const bool room = gate.wait(lock, drained, [this, &text] {
+                return queued.empty() || queued.size() + text.size() + 1 <= capacity;
+            });
+            if (!room) return false;
+
+            if (!writer.joinable())
+            {
+                // Reserved up front so that appending doesn't move the queue under `emergencyFlush()`
+                queued.reserve(capacity);
+                writing.reserve(capacity);
+                writer = std::thread(&ConsoleWriter::run, this);
+            }
+            queued.append(text);
+            queued.push_back('\n');
+            wake.notify_one();
+            return true;
+        }
+
+        /**
+         * Write the lines still queued straight to stdout and stderr with nothing but `write`, for crash handlers. It
+         * takes no lock, so it may race with a line being queued; lines the writer thread already took are left to it.
+         */
+        void emergencyFlush() const
+        {
+            const std::size_t size = queued.size();
+            if (size == 0) return;
+            writeAll(STDOUT_FILENO, queued.data(), size);
+            writeAll(STDERR_FILENO, queued.data(), size);
+        }
+
+        /**
+         * Wait until everything queued so far has been written, e.g. before the console or nxlink goes away
+         */
+        void flush()
+        {
+            std::unique_lock lock(mutex);
+            drained.wait(lock, [this] { return queued.empty() && !busy; });
+        }
+    };
+}
+
+#endif //AXOLOGL_CONSOLE_H
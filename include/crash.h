@@ -0,0 +1,396 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_CRASH_H
+#define AXOLOGL_CRASH_H
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <memory>
+#include <new>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "axologl.h"
+
+/*
+ * Last-gasp logging for crashes. Everything reachable from a handler here is async-signal-safe: no allocation, no
+ * locks, no stdio, only `write`. The buffered tail of the log file, any console lines still queued and a final FATAL
+ * record are written out, and then the crash is allowed to proceed as it would have without us.
+ *
+ * The FATAL record can't be formatted in a handler, so it is laid out with the file pattern ahead of time, whenever
+ * Axologl is configured, around the spot where the reason goes. The handler only copies it and stamps the current
+ * local time into its `%T` fields. A `%t` field shows the thread that configured Axologl.
+ */
+namespace axologl::crash
+{
+    namespace detail
+    {
+        inline std::atomic_flag flushed = ATOMIC_FLAG_INIT;
+        inline char record[320];
+        inline std::terminate_handler previousTerminate = nullptr;
+
+        // The FATAL record, laid out by `prepare()` on either side of the reason
+        inline constexpr std::size_t timeLength = 23;
+        inline char prefix[160] = "[FATAL] Crashed: ";
+        inline std::size_t prefixLength = 17;
+        inline char suffix[64] = "";
+        inline std::size_t suffixLength = 0;
+        // Where each `%T` field starts, in `prefix` or in `suffix`
+        struct TimeField
+        {
+            bool inSuffix;
+            std::size_t at;
+        };
+        inline TimeField timeFields[4];
+        inline std::size_t timeFieldCount = 0;
+        // Seconds to add to UTC for local time, as of `prepare()`
+        inline std::int64_t utcOffset = 0;
+
+        inline std::size_t appendText(std::size_t length, const char* text)
+        {
+            while (*text != '\0' && length < sizeof(record) - 1)
+            {
+                record[length++] = *text++;
+            }
+            return length;
+        }
+
+        inline std::size_t appendBytes(std::size_t length, const char* data, const std::size_t size)
+        {
+            for (std::size_t i = 0; i < size && length < sizeof(record) - 1; i++)
+            {
+                record[length++] = data[i];
+            }
+            return length;
+        }
+
+        inline std::size_t appendNumber(std::size_t length, const std::uint32_t value)
+        {
+            char digits[10];
+            std::size_t count = 0;
+            std::uint32_t remaining = value;
+            do
+            {
+                digits[count++] = static_cast<char>('0' + remaining % 10);
+                remaining /= 10;
+            }
+            while (remaining != 0);
+
+            while (count > 0 && length < sizeof(record) - 1)
+            {
+                record[length++] = digits[--count];
+            }
+            return length;
+        }
+
+        inline void writeAll(const int fd, const char* data, std::size_t size)
+        {
+            while (size > 0)
+            {
+                const ssize_t written = ::write(fd, data, size);
+                if (written <= 0) return;
+                data += written;
+                size -= written;
+            }
+        }
+
+        // Days since 1970-01-01 of a proleptic Gregorian date, and back (Howard Hinnant's civil date algorithms)
+        inline std::int64_t daysFromCivil(std::int64_t year, const unsigned month, const unsigned day)
+        {
+            year -= month <= 2;
+            const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+            const auto yearOfEra = static_cast<unsigned>(year - era * 400);
+            const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+            const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+            return era * 146097 + static_cast<std::int64_t>(dayOfEra) - 719468;
+        }
+
+        inline void civilFromDays(std::int64_t days, std::int64_t& year, unsigned& month, unsigned& day)
+        {
+            days += 719468;
+            const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+            const auto dayOfEra = static_cast<unsigned>(days - era * 146097);
+            const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+            const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+            const unsigned shifted = (5 * dayOfYear + 2) / 153;
+            day = dayOfYear - (153 * shifted + 2) / 5 + 1;
+            month = shifted < 10 ? shifted + 3 : shifted - 9;
+            year = static_cast<std::int64_t>(yearOfEra) + era * 400 + (month <= 2);
+        }
+
+        inline std::int64_t secondsOf(const std::tm& parts)
+        {
+            return daysFromCivil(parts.tm_year + 1900, parts.tm_mon + 1, parts.tm_mday) * 86400
+                + parts.tm_hour * 3600 + parts.tm_min * 60 + parts.tm_sec;
+        }
+
+        /**
+         * Write the current local time as `%T` renders it, `timeLength` characters, without `localtime`
+         */
+        inline void formatNow(char* out)
+        {
+            timespec now{};
+            clock_gettime(CLOCK_REALTIME, &now);
+            const std::int64_t local = static_cast<std::int64_t>(now.tv_sec) + utcOffset;
+            const std::int64_t days = (local >= 0 ? local : local - 86399) / 86400;
+            const auto second = static_cast<unsigned>(local - days * 86400);
+            std::int64_t year;
+            unsigned month, day;
+            civilFromDays(days, year, month, day);
+
+            const unsigned fields[] = {static_cast<unsigned>(year), month, day, second / 3600, second / 60 % 60,
+                                       second % 60, static_cast<unsigned>(now.tv_nsec / 1000000)};
+            const int widths[] = {4, 2, 2, 2, 2, 2, 3};
+            const char separators[] = {'-', '-', ' ', ':', ':', '.', '\0'};
+            std::size_t at = 0;
+            for (std::size_t i = 0; i < 7; i++)
+            {
+                unsigned value = fields[i];
+                for (int digit = widths[i] - 1; digit >= 0; digit--)
+                {
+                    out[at + digit] = static_cast<char>('0' + value % 10);
+                    value /= 10;
+                }
+                at += widths[i];
+                if (separators[i] != '\0') out[at++] = separators[i];
+            }
+        }
+
+        /**
+         * Lay out the FATAL record with the Fatal logger's file pattern. Not signal-safe; run from `configure()`.
+         */
+        inline void prepare()
+        {
+            Axologl* const instance = _axologl.load(std::memory_order_acquire);
+            if (instance == nullptr) return;
+
+            // An empty message, marked so that the reason can go in its place
+            std::string line;
+            std::vector<std::size_t> times;
+            const Record marker{Fatal, std::string_view("\0", 1), noSite, wallClockMs(), currentThreadId()};
+            instance->getLogger(Fatal).getFileLayout().render(marker, line, false, false, &times);
+
+            std::size_t split = line.find('\0');
+            if (split == std::string::npos)
+            {
+                // The pattern has no `%m`, so the reason follows the line
+                line.push_back(' ');
+                split = line.size();
+                line.push_back('\0');
+            }
+            std::string before = line.substr(0, split) + "Crashed: ";
+            std::string after = line.substr(split + 1);
+            before.resize(std::min(before.size(), sizeof(prefix)));
+            after.resize(std::min(after.size(), sizeof(suffix)));
+
+            timeFieldCount = 0;
+            for (const std::size_t at : times)
+            {
+                if (timeFieldCount == std::size(timeFields)) break;
+                const bool inSuffix = at > split;
+                const std::size_t offset = inSuffix ? at - split - 1 : at;
+                if (offset + timeLength > (inSuffix ? after.size() : before.size())) continue;
+                timeFields[timeFieldCount++] = TimeField{inSuffix, offset};
+            }
+            std::memcpy(prefix, before.data(), before.size());
+            prefixLength = before.size();
+            std::memcpy(suffix, after.data(), after.size());
+            suffixLength = after.size();
+
+            const std::time_t now = std::time(nullptr);
+            std::tm local{};
+            std::tm utc{};
+            localtime_r(&now, &local);
+            gmtime_r(&now, &utc);
+            utcOffset = secondsOf(local) - secondsOf(utc);
+        }
+
+        inline const char* signalName(const int signal)
+        {
+            switch (signal)
+            {
+            case SIGSEGV: return "SIGSEGV";
+            case SIGILL: return "SIGILL";
+            case SIGFPE: return "SIGFPE";
+            case SIGABRT: return "SIGABRT";
+#ifdef SIGBUS
+            case SIGBUS: return "SIGBUS";
+#endif
+            default: return "signal";
+            }
+        }
+    }
+
+    /**
+     * Write out any buffered log output and queued console lines, followed by a FATAL record describing the crash.
+     * Only the first call does anything, so nested or concurrent crashes can't interleave their output.
+     *
+     * @param reason    A short description, e.g. a signal name
+     * @param code      A number to go with it, e.g. the signal number
+     */
+    inline void emergencyFlush(const char* reason, const std::uint32_t code)
+    {
+        if (detail::flushed.test_and_set()) return;
+
+        std::size_t length = detail::appendBytes(0, detail::prefix, detail::prefixLength);
+        length = detail::appendText(length, reason);
+        length = detail::appendText(length, " (");
+        length = detail::appendNumber(length, code);
+        length = detail::appendText(length, ")");
+        const std::size_t suffixStart = length;
+        length = detail::appendBytes(length, detail::suffix, detail::suffixLength);
+        detail::record[length++] = '\n';
+
+        char now[detail::timeLength];
+        detail::formatNow(now);
+        for (std::size_t i = 0; i < detail::timeFieldCount; i++)
+        {
+            const detail::TimeField field = detail::timeFields[i];
+            const std::size_t at = field.inSuffix ? suffixStart + field.at : field.at;
+            if (at + detail::timeLength < length) std::memcpy(detail::record + at, now, detail::timeLength);
+        }
+
+        // If the crash interrupted a write, the buffer may end mid-record; that's still better than losing it
+        if (const FileLogger* fileLogger = _fileLogger.get())
+        {
+            fileLogger->emergencyFlush(detail::record, length);
+        }
+        Logger::emergencyFlushConsole();
+        detail::writeAll(STDOUT_FILENO, detail::record, length);
+        detail::writeAll(STDERR_FILENO, detail::record, length);
+    }
+
+    namespace detail
+    {
+        inline void onSignal(const int signal)
+        {
+            emergencyFlush(signalName(signal), static_cast<std::uint32_t>(signal));
+            // The handler was installed one-shot, so this gets the default action (and a core dump, if enabled)
+            raise(signal);
+        }
+
+        inline void onTerminate()
+        {
+            emergencyFlush("std::terminate", 0);
+            if (previousTerminate != nullptr) previousTerminate();
+            std::abort();
+        }
+
+#ifndef __SWITCH__
+        inline constexpr std::size_t alternateStackSize = 64 * 1024;
+        inline char alternateStack[alternateStackSize];
+
+        inline void setAlternateStack(char* memory, const std::size_t size)
+        {
+            stack_t stack{};
+            stack.ss_sp = memory;
+            stack.ss_size = size;
+            sigaltstack(&stack, nullptr);
+        }
+
+        // A worker thread's stack from `installThread()`, taken down again before the memory is freed
+        struct ThreadStack
+        {
+            std::unique_ptr<char[]> memory;
+
+            ~ThreadStack()
+            {
+                if (memory == nullptr) return;
+                stack_t disable{};
+                disable.ss_flags = SS_DISABLE;
+                sigaltstack(&disable, nullptr);
+            }
+        };
+
+        inline thread_local ThreadStack threadStack;
+#endif
+    }
+
+    /**
+     * Install the crash handlers: fatal signals (SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT) and `std::terminate`.
+     * Call this after `configure()`. On the Switch, CPU exceptions are caught by
+     * `AXOLOGL_INSTALL_EXCEPTION_HANDLER()` instead, since libnx doesn't deliver them as signals.
+     *
+     * The handlers are process-wide, but the alternate stack they run on is per thread and only set up for the
+     * thread that calls this. A stack overflow on any other thread kills it without a log record unless that thread
+     * calls `installThread()`.
+     */
+    inline void install()
+    {
+        // Lay out the FATAL record now, and again whenever Axologl is reconfigured
+        detail::prepare();
+        _onConfigure = detail::prepare;
+        detail::previousTerminate = std::set_terminate(detail::onTerminate);
+
+#ifdef __SWITCH__
+        std::signal(SIGABRT, detail::onSignal);
+#else
+        // A stack overflow can't run its handler on the stack that overflowed
+        detail::setAlternateStack(detail::alternateStack, detail::alternateStackSize);
+
+        struct sigaction action{};
+        action.sa_handler = detail::onSignal;
+        action.sa_flags = SA_RESETHAND | SA_ONSTACK;
+        sigemptyset(&action.sa_mask);
+        for (const int signal : {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT})
+        {
+            sigaction(signal, &action, nullptr);
+        }
+#endif
+    }
+
+    /**
+     * Give the calling thread its own stack for the crash handlers, so that a stack overflow on it is still logged.
+     * Call this at the start of every worker thread; the stack is freed when the thread exits. Does nothing on the
+     * Switch, where CPU exceptions don't go through signals.
+     */
+    inline void installThread()
+    {
+#ifndef __SWITCH__
+        if (detail::threadStack.memory != nullptr) return;
+        detail::threadStack.memory.reset(new (std::nothrow) char[detail::alternateStackSize]);
+        if (detail::threadStack.memory == nullptr) return;
+        detail::setAlternateStack(detail::threadStack.memory.get(), detail::alternateStackSize);
+#endif
+    }
+}
+
+#ifdef __SWITCH__
+/**
+ * Define libnx's exception handler so that CPU exceptions flush the log before the process dies. Use this once, at
+ * namespace scope, in exactly one source file.
+ */
+#define AXOLOGL_INSTALL_EXCEPTION_HANDLER()                                                 \
+    extern "C"                                                                              \
+    {                                                                                       \
+        u32 __nx_exception_ignoredebug = 1;                                                 \
+        void __libnx_exception_handler(ThreadExceptionDump* context)                        \
+        {                                                                                   \
+            axologl::crash::emergencyFlush("CPU exception", context->error_desc);           \
+            svcExitProcess();                                                               \
+        }                                                                                   \
+    }
+#endif
+
+#endif //AXOLOGL_CRASH_H
@@ -0,0 +1,132 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_EARLY_H
+#define AXOLOGL_EARLY_H
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <thread>
+
+#include "layout.h"
+#include "levels.h"
+#include "location.h"
+
+/*
+ * Holds records logged while Axologl isn't configured, i.e. before `configure()` (static initializers, early boot) or
+ * after `teardown()`, until the next `configure()` replays them. Everything here is constant-initialized and
+ * allocation-free, so it works from any static initializer regardless of initialization order. Callers check the
+ * log level first (see `axologl::defer()`), so filtered records cost nothing here.
+ */
+namespace axologl::early
+{
+    // Only the first records are kept; the rest are counted and reported on replay
+    inline constexpr std::size_t capacity = 64;
+    inline constexpr std::size_t textSize = 200;
+
+    struct Entry
+    {
+        std::atomic<bool> ready{false};
+        LogLevel level = Raw;
+        SiteId site = noSite;
+        std::uint64_t time = 0;
+        std::uint32_t thread = 0;
+        std::uint32_t length = 0;
+        char text[textSize]{};
+    };
+
+    namespace detail
+    {
+        inline Entry entries[capacity];
+        inline std::atomic<std::size_t> claimed{0};
+    }
+
+    /**
+     * Keep a record for replay. Text longer than `textSize` is cut short and ends in `...`.
+     *
+     * Costs an atomic increment, a clock read, a thread id lookup and a copy of at most `textSize` bytes, with no locks
+     * or allocation. Once the buffer is full it is just the increment.
+     */
+    inline void push(const LogLevel level, const std::string_view text, const SiteId site = noSite)
+    {
+        // Acquire pairs with the reset in `replay()`, which is done reading the entry this may reuse
+        const std::size_t index = detail::claimed.fetch_add(1, std::memory_order_acquire);
+        if (index >= capacity)
+        {
+            return;
+        }
+
+        Entry& entry = detail::entries[index];
+        entry.level = level;
+        entry.site = site;
+        entry.time = wallClockMs();
+        entry.thread = currentThreadId();
+        entry.length = static_cast<std::uint32_t>(text.size() < textSize ? text.size() : textSize);
+        std::memcpy(entry.text, text.data(), entry.length);
+        if (text.size() > textSize) std::memcpy(entry.text + textSize - 3, "...", 3);
+        entry.ready.store(true, std::memory_order_release);
+    }
+
+    /**
+     * Hand every kept record to `sink`, oldest first, and empty the buffer. Records still being pushed by other threads
+     * are waited for, which is brief since `push()` never blocks, so none is lost or read half-written.
+     *
+     * @param sink  Called with each record as a `Record`, carrying its original time and thread
+     *
+     * @return How many records didn't fit and were dropped
+     */
+    template <typename Sink>
+    std::size_t replay(Sink&& sink)
+    {
+        std::size_t count = detail::claimed.load(std::memory_order_acquire);
+        std::size_t done = 0;
+        for (;;)
+        {
+            const std::size_t kept = count < capacity ? count : capacity;
+            for (; done < kept; done++)
+            {
+                // Claimed, so its writer is between `fetch_add` and `ready.store`
+                Entry& entry = detail::entries[done];
+                while (!entry.ready.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+
+                sink(Record{entry.level, std::string_view(entry.text, entry.length), entry.site, entry.time,
+                            entry.thread});
+                entry.ready.store(false, std::memory_order_release);
+            }
+
+            // Every entry is taken, so later claims only count drops and can be reset along with them
+            if (count >= capacity)
+            {
+                count = detail::claimed.exchange(0, std::memory_order_acq_rel);
+                break;
+            }
+            // Only reset if nothing was claimed meanwhile; otherwise replay the new entries too
+            if (detail::claimed.compare_exchange_weak(count, 0, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                break;
+            }
+        }
+        return count > capacity ? count - capacity : 0;
+    }
+}
+
+#endif //AXOLOGL_EARLY_H
@@ -18,7 +18,22 @@
 
 #ifndef AXOLOGL_FILE_H
 #define AXOLOGL_FILE_H
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "compress.h"
+#include "index.h"
+#include "overload.h"
+#include "stats.h"
+#include "tail.h"
+#include "types.h"
 
 namespace fs = std::filesystem;
 
@@ -26,8 +41,63 @@ namespace axologl
 {
     class FileLogger
     {
+        // Plain-text output is buffered here rather than in stdio, so that a crash handler can still reach it
+        static constexpr std::size_t plainBufferSize = 16 * 1024;
+
+        // What `emergencyFlush()` can expect of `pendingBlock`
+        enum PendingState : int
+        {
+            Empty,
+            Queued,
+            Writing
+        };
+
         fs::path _logPath;
         FILE* logFile = nullptr;
+        int fd = -1;
+        bool compressed = false;
+        // Held by logging threads while they fill `block`; never held during file I/O
+        std::mutex writeMutex;
+        std::vector<char> block;
+        // Index entries for the data in `block`, written once it is in the file
+        std::vector<index::Entry> blockEntries;
+        std::size_t blockCapacity = plainBufferSize;
+        std::unique_ptr<index::IndexWriter> indexWriter;
+        // Where `block` will start in a plain-text log, counting blocks the writer hasn't written yet
+        std::uint64_t fileOffset = 0;
+        std::uint64_t indexBlockStart = 0;
+        std::uint64_t recordsWritten = 0;
+
+        // A full block is handed to the writer thread, which does the encoding and the I/O, so logging threads never
+        // wait on storage unless they run a whole block ahead of it. Guarded by `handoffMutex`, taken after
+        // `writeMutex`.
+        std::mutex handoffMutex;
+        std::condition_variable writerWake;
+        std::condition_variable writerDone;
+        std::vector<char> pendingBlock;
+        std::vector<index::Entry> pendingEntries;
+        std::atomic<int> pendingState{Empty};
+        std::uint64_t blocksHandedOff = 0;
+        std::uint64_t blocksWritten = 0;
+        bool writerBusy = false;
+        bool writerStopping = false;
+        std::thread writer;
+        // Only touched by the writer thread
+        compress::FrameEncoder encoder;
+        std::uint64_t writerOffset = 0;
+        // Where a plain-text log ends on disk, published by the writer for readers that mustn't take `writeMutex`
+        std::atomic<std::uint64_t> writtenEnd{0};
+
+        // Group commit: one thread flushes and syncs on behalf of everyone waiting; guarded by `syncMutex`
+        Durability durability = Durability::None;
+        std::chrono::milliseconds syncInterval;
+        std::mutex syncMutex;
+        std::condition_variable syncDone;
+        std::condition_variable flusherWake;
+        std::uint64_t recordsSynced = 0;
+        bool syncing = false;
+        bool stopping = false;
+        std::thread flusher;
 
         [[nodiscard]] bool ensurePath() const
         {
@@ -40,9 +110,252 @@ namespace axologl
             return true;
         }
 
-        void write(const std::string& text) const
+        bool write(const std::string& text, const LogLevel level, OverloadGate& gate, std::uint64_t& recordOffset,
+                   const std::uint64_t firstTime, const std::uint64_t lastTime)
+        {
+            const clock::Ticks start = clock::now();
+            recordOffset = noFileOffset;
+            std::uint64_t sequence;
+            {
+                std::unique_lock lock = gate.enter(writeMutex);
+                if (!lock.owns_lock()) return false;
+
+                // Start a new block rather than split a record that would fit in one. The writer may still be busy
+                // with the previous block, and then the policy decides whether this record waits for it.
+                if (!block.empty() && block.size() + text.size() + 1 > blockCapacity)
+                {
+                    if (!writerIdle(gate)) return false;
+                    handOff();
+                }
+
+                sequence = ++recordsWritten;
+                if (indexWriter) indexWriter->addRecord(level, text, firstTime, lastTime);
+                if (!compressed) recordOffset = fileOffset + block.size();
+                append(text.data(), text.size());
+                append("\n", 1);
+
+                if (!compressed && indexWriter && fileOffset + block.size() - indexBlockStart >= index::blockInterval)
+                {
+                    // Written by the writer after the block it ends in, so it never covers bytes not yet in the file
+                    const std::uint64_t end = fileOffset + block.size();
+                    blockEntries.push_back(indexWriter->finishBlock(indexBlockStart, end, false));
+                    indexBlockStart = end;
+                }
+            }
+            if (durability == Durability::OnError && (level == Error || level == Fatal))
+            {
+                syncThrough(sequence);
+            }
+            Stats::add(_stats.bytes[File], text.size() + 1);
+            _stats.fileWriteLatency.recordTicks(start);
+            return true;
+        }
+
+        void append(const char* data, std::size_t size)
+        {
+            while (size > 0)
+            {
+                if (block.size() == blockCapacity)
+                {
+                    // Only a record larger than a block gets here, and it is already partly in, so it must wait
+                    OverloadGate blocking;
+                    writerIdle(blocking);
+                    handOff();
+                }
+                const std::size_t room = blockCapacity - block.size();
+                const std::size_t take = size < room ? size : room;
+                block.insert(block.end(), data, data + take);
+                data += take;
+                size -= take;
+            }
+        }
+
+        /**
+         * Wait for the writer to finish the block it was last handed, for as long as `gate`'s policy allows. Called
+         * with `writeMutex` held, so no other block can be handed off meanwhile.
+         *
+         * @return Whether the writer is idle
+         */
+        bool writerIdle(OverloadGate& gate)
+        {
+            std::unique_lock lock(handoffMutex);
+            return gate.wait(lock, writerDone, [this] { return !writerBusy; });
+        }
+
+        /**
+         * Give `block` to the writer thread. Called with `writeMutex` held and the writer idle.
+         *
+         * @return The number of blocks handed off so far, for `waitForWriter()`
+         */
+        std::uint64_t handOff()
+        {
+            std::unique_lock lock(handoffMutex);
+            if (block.empty() && blockEntries.empty()) return blocksHandedOff;
+
+            // A compressed block's place in the file is only known once the writer has encoded it
+            if (compressed && indexWriter && !block.empty())
+            {
+                blockEntries.push_back(indexWriter->finishBlock(0, 0, true));
+            }
+            if (!compressed) fileOffset += block.size();
+            block.swap(pendingBlock);
+            blockEntries.swap(pendingEntries);
+            pendingState.store(Queued, std::memory_order_release);
+            writerBusy = true;
+            blocksHandedOff++;
+            writerWake.notify_one();
+            return blocksHandedOff;
+        }
+
+        /**
+         * Wait until the first `target` blocks handed off are in the file. Doesn't need `writeMutex`.
+         */
+        void waitForWriter(const std::uint64_t target)
+        {
+            std::unique_lock lock(handoffMutex);
+            writerDone.wait(lock, [this, target] { return blocksWritten >= target; });
+        }
+
+        void runWriter()
+        {
+            std::unique_lock lock(handoffMutex);
+            for (;;)
+            {
+                writerWake.wait(lock, [this] { return writerBusy || writerStopping; });
+                if (!writerBusy) break;
+
+                lock.unlock();
+                writePending();
+                lock.lock();
+
+                writerBusy = false;
+                blocksWritten++;
+                writerDone.notify_all();
+            }
+        }
+
+        void writePending()
+        {
+            pendingState.store(Writing, std::memory_order_release);
+            if (!pendingBlock.empty())
+            {
+                if (compressed)
+                {
+                    // Each block goes out whole so that a crash can only ever lose the block being written
+                    const std::string_view frame = encoder.encode(pendingBlock.data(), pendingBlock.size());
+                    fwrite(frame.data(), 1, frame.size(), logFile);
+                    for (index::Entry& entry : pendingEntries)
+                    {
+                        if ((entry.flags & index::compressedBlock) == 0) continue;
+                        entry.offset = writerOffset;
+                        entry.length = static_cast<std::uint32_t>(frame.size());
+                    }
+                    writerOffset += frame.size();
+                }
+                else
+                {
+                    fwrite(pendingBlock.data(), 1, pendingBlock.size(), logFile);
+                    writerOffset += pendingBlock.size();
+                    writtenEnd.store(writerOffset, std::memory_order_release);
+                }
+                Stats::add(_stats.blockWrites);
+            }
+            for (const index::Entry& entry : pendingEntries)
+            {
+                indexWriter->writeEntry(entry);
+            }
+            pendingBlock.clear();
+            pendingEntries.clear();
+            pendingState.store(Empty, std::memory_order_release);
+        }
+
+        /**
+         * Hand off whatever is buffered and wait until it is in the file
+         *
+         * @return How many records that covers
+         */
+        std::uint64_t flushBuffered()
+        {
+            std::uint64_t target;
+            std::uint64_t covered;
+            {
+                std::lock_guard lock(writeMutex);
+                OverloadGate blocking;
+                writerIdle(blocking);
+                target = handOff();
+                covered = recordsWritten;
+            }
+            waitForWriter(target);
+            return covered;
+        }
+
+        /**
+         * Make sure the first `target` records are on storage. Whoever finds no sync in progress leads, flushing and
+         * syncing every record written so far; anyone arriving meanwhile waits and is usually covered by that sync
+         * rather than paying for their own.
+         */
+        void syncThrough(const std::uint64_t target)
+        {
+            std::unique_lock lock(syncMutex);
+            while (recordsSynced < target)
+            {
+                if (syncing)
+                {
+                    syncDone.wait(lock);
+                    continue;
+                }
+
+                syncing = true;
+                lock.unlock();
+                const std::uint64_t covered = flushBuffered();
+                fsync(fd);
+                Stats::add(_stats.syncs);
+                lock.lock();
+
+                syncing = false;
+                recordsSynced = covered;
+                syncDone.notify_all();
+            }
+        }
+
+        void runFlusher()
+        {
+            std::unique_lock lock(syncMutex);
+            while (!stopping)
+            {
+                flusherWake.wait_for(lock, syncInterval);
+                if (stopping) break;
+
+                lock.unlock();
+                sync();
+                lock.lock();
+            }
+        }
+
+        void writeAll(const char* data, std::size_t size) const
         {
-            fputs((text + "\n").c_str(), logFile);
+            while (size > 0)
+            {
+                const ssize_t written = ::write(fd, data, size);
+                if (written <= 0) return;
+                data += written;
+                size -= written;
+            }
+        }
+
+        /**
+         * Write `size` bytes as an uncompressed frame block; allocation-free so that it can run in a crash handler
+         */
+        void writeStoredBlock(const char* data, const std::size_t size) const
+        {
+            if (size == 0) return;
+
+            char header[compress::blockHeaderSize];
+            compress::detail::writeLE32(header, static_cast<std::uint32_t>(size) | compress::storedFlag);
+            compress::detail::writeLE32(header + 4, static_cast<std::uint32_t>(size));
+            compress::detail::writeLE32(header + 8, compress::checksum(data, size));
+            writeAll(header, sizeof(header));
+            writeAll(data, size);
         }
 
         [[nodiscard]] fs::path getLogFilename() const
@@ -61,7 +374,19 @@ namespace axologl
         }
 
     public:
-        explicit FileLogger(const fs::path& logPath)
+        /**
+         * @param logPath   Where to write the log; a directory gets a default filename
+         * @param compress  Whether to write block-compressed output (see `compress.h`) instead of plain text
+         * @param index     Whether to maintain a sidecar index next to the log (see `index.h`)
+         * @param durability    When to flush and sync the log (see `Durability`)
+         * @param syncInterval  How often to sync with `Durability::Periodic`
+         * @param filePattern   The pattern records are laid out with, recorded in the index for its readers
+         */
+        explicit FileLogger(const fs::path& logPath, const bool compress = false, const bool index = false,
+                            const Durability durability = Durability::None,
+                            const std::chrono::milliseconds syncInterval = std::chrono::milliseconds(1000),
+                            const std::string_view filePattern = defaultPattern)
+            : compressed(compress), durability(durability), syncInterval(syncInterval)
         {
             _logPath = logPath;
             // Check our write path exists, create it if not
@@ -79,15 +404,79 @@ namespace axologl
                 else
                 {
                     // Use a default filename
-                    _logPath.append("/axologl.log");
+                    _logPath.append(compressed ? "/axologl.axlz" : "/axologl.log");
                 }
 
-                logFile = fopen(_logPath.c_str(), "a+");
+                logFile = fopen(_logPath.c_str(), compressed ? "ab" : "a+");
+                if (logFile != nullptr)
+                {
+                    // All buffering happens in `block`
+                    setvbuf(logFile, nullptr, _IONBF, 0);
+                    fd = fileno(logFile);
+                    fseek(logFile, 0, SEEK_END);
+                    fileOffset = ftell(logFile);
+                    indexBlockStart = fileOffset;
+                }
+                if (logFile != nullptr && compressed)
+                {
+                    blockCapacity = compress::maxBlockSize;
+                    const std::string_view header = compress::FrameEncoder::header();
+                    fwrite(header.data(), 1, header.size(), logFile);
+                    fileOffset += header.size();
+                }
+                writerOffset = fileOffset;
+                writtenEnd.store(writerOffset, std::memory_order_relaxed);
+                block.reserve(blockCapacity);
+                pendingBlock.reserve(blockCapacity);
+                if (logFile != nullptr && index)
+                {
+                    indexWriter = std::make_unique<index::IndexWriter>(index::indexPathFor(_logPath), filePattern);
+                    // A crash can leave up to a checkpoint's worth of records that the index never got to
+                    if (!compressed) indexWriter->indexUnindexed(logFile, fileOffset);
+                }
+                if (logFile != nullptr)
+                {
+                    writer = std::thread(&FileLogger::runWriter, this);
+                }
+                if (logFile != nullptr && durability == Durability::Periodic)
+                {
+                    flusher = std::thread(&FileLogger::runFlusher, this);
+                }
             }
         }
 
         ~FileLogger()
         {
+            if (logFile == nullptr) return;
+
+            if (flusher.joinable())
+            {
+                {
+                    std::lock_guard lock(syncMutex);
+                    stopping = true;
+                }
+                flusherWake.notify_all();
+                flusher.join();
+            }
+
+            flushBuffered();
+            {
+                std::lock_guard lock(handoffMutex);
+                writerStopping = true;
+            }
+            writerWake.notify_all();
+            writer.join();
+
+            std::lock_guard lock(writeMutex);
+            if (!compressed && indexWriter && indexWriter->hasOpenBlock())
+            {
+                indexWriter->closeBlock(indexBlockStart, fileOffset, false);
+            }
+            if (durability != Durability::None)
+            {
+                fsync(fd);
+                Stats::add(_stats.syncs);
+            }
             fclose(logFile);
         }
 
@@ -96,10 +485,101 @@ namespace axologl
             return logFile != nullptr;
         }
 
-        void log(const std::string& text) const
+        /**
+         * @return Where the record starts in a plain-text log, or `noFileOffset` for a compressed one
+         */
+        std::uint64_t log(const std::string& text, const LogLevel level = Raw)
+        {
+            OverloadGate blocking;
+            std::uint64_t offset;
+            const std::uint64_t time = wallClockMs();
+            write(text, level, blocking, offset, time, time);
+            return offset;
+        }
+
+        /**
+         * Write a record unless `gate`'s overload policy says to drop it because another thread is writing
+         *
+         * @param offset    Set to where the record starts in a plain-text log, or `noFileOffset`
+         * @param firstTime When the first record in `text` was logged, in milliseconds since the Unix epoch, for the
+         *                  index
+         * @param lastTime  When the last one was, which is the same for a single record
+         *
+         * @return Whether the record was written
+         */
+        bool log(const std::string& text, const LogLevel level, OverloadGate& gate, std::uint64_t& offset,
+                 const std::uint64_t firstTime, const std::uint64_t lastTime)
+        {
+            return write(text, level, gate, offset, firstTime, lastTime);
+        }
+
+        /**
+         * @return Where a plain-text log ends on disk. Records past it are still buffered; this never waits for them.
+         */
+        [[nodiscard]] std::uint64_t writtenSize() const
+        {
+            return writtenEnd.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] const fs::path& getLogPath() const
+        {
+            return _logPath;
+        }
+
+        [[nodiscard]] bool isCompressed() const
         {
-            // Write to file
-            write(text);
+            return compressed;
+        }
+
+        /**
+         * Write out everything buffered so far, without waiting for it to reach storage, so that readers of the file
+         * see it
+         */
+        void flush()
+        {
+            flushBuffered();
+        }
+
+        /**
+         * Flush everything logged so far and wait until it is on storage, sharing a sync with any other thread
+         * already doing so
+         */
+        void sync()
+        {
+            std::uint64_t target;
+            {
+                std::lock_guard lock(writeMutex);
+                target = recordsWritten;
+            }
+            syncThrough(target);
+        }
+
+        /**
+         * Write whatever is still buffered, followed by `record`, using nothing but `write`. This is the crash path:
+         * it neither allocates nor locks, so it is async-signal-safe, but it may race with a write the crash
+         * interrupted. A block the writer thread was part way through is lost.
+         *
+         * @param record    A preformatted final record, including its newline
+         * @param length    Length of `record`
+         */
+        void emergencyFlush(const char* record, const std::size_t length) const
+        {
+            if (fd < 0) return;
+
+            // Handed off, but the writer hasn't started on it
+            const bool pending = pendingState.load(std::memory_order_acquire) == Queued;
+            if (compressed)
+            {
+                if (pending) writeStoredBlock(pendingBlock.data(), pendingBlock.size());
+                writeStoredBlock(block.data(), block.size());
+                writeStoredBlock(record, length);
+            }
+            else
+            {
+                if (pending) writeAll(pendingBlock.data(), pendingBlock.size());
+                writeAll(block.data(), block.size());
+                writeAll(record, length);
+            }
         }
     };
 }
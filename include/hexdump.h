@@ -0,0 +1,404 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_HEXDUMP_H
+#define AXOLOGL_HEXDUMP_H
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "axologl.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define AXOLOGL_HEX_X86
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#define AXOLOGL_HEX_NEON
+#include <arm_neon.h>
+#endif
+
+/*
+ * Binary payloads in the classic offset/hex/ASCII layout, 16 bytes per line:
+ *
+ *     00000000  48 65 6c 6c 6f 2c 20 6e  78 6c 69 6e 6b 21 0a 00  |Hello, nxlink!..|
+ *
+ * Full lines are encoded 16 (or 32, with AVX2) bytes at a time straight into the output buffer, which is sized once
+ * up front; the last partial line is done byte by byte.
+ */
+namespace axologl::hex
+{
+    inline constexpr std::size_t bytesPerLine = 16;
+    inline constexpr std::size_t lineLength = 78;
+
+    /**
+     * The ways a line can be encoded. `fastest()` picks one for the running CPU; the others are there to compare
+     * against.
+     */
+    enum class Encoder
+    {
+        Scalar,
+        Ssse3,
+        Avx2,
+        Neon
+    };
+
+    namespace detail
+    {
+        inline constexpr char digits[] = "0123456789abcdef";
+        inline constexpr std::size_t asciiColumn = 61;
+
+        // Where byte `i` of a line has its two hex digits; the two groups of eight are split by an extra space
+        constexpr std::size_t hexColumn(const std::size_t i)
+        {
+            return 10 + i * 3 + (i >= 8 ? 1 : 0);
+        }
+
+        inline void writeOffset(char* out, std::uint64_t offset)
+        {
+            for (int i = 7; i >= 0; i--)
+            {
+                out[i] = digits[offset & 0xF];
+                offset >>= 4;
+            }
+            out[8] = ' ';
+            out[9] = ' ';
+        }
+
+        /**
+         * Encode one line of up to 16 bytes
+         *
+         * @return The line's length, which is shorter than `lineLength` for a partial line
+         */
+        inline std::size_t encodeLineScalar(const std::uint8_t* data, const std::size_t count,
+                                            const std::uint64_t offset, char* out)
+        {
+            writeOffset(out, offset);
+            std::memset(out + 10, ' ', asciiColumn - 11);
+            for (std::size_t i = 0; i < count; i++)
+            {
+                out[hexColumn(i)] = digits[data[i] >> 4];
+                out[hexColumn(i) + 1] = digits[data[i] & 0xF];
+            }
+
+            out[asciiColumn - 1] = '|';
+            for (std::size_t i = 0; i < count; i++)
+            {
+                out[asciiColumn + i] = data[i] >= 0x20 && data[i] < 0x7F ? static_cast<char>(data[i]) : '.';
+            }
+            out[asciiColumn + count] = '|';
+            return asciiColumn + count + 1;
+        }
+
+        inline void encodeLinesScalar(const std::uint8_t* data, const std::size_t lines, std::uint64_t offset,
+                                      char* out)
+        {
+            for (std::size_t line = 0; line < lines; line++)
+            {
+                encodeLineScalar(data, bytesPerLine, offset, out);
+                if (line + 1 < lines) out[lineLength] = '\n';
+                data += bytesPerLine;
+                offset += bytesPerLine;
+                out += lineLength + 1;
+            }
+        }
+
+#if defined(AXOLOGL_HEX_X86) || defined(AXOLOGL_HEX_NEON)
+        // Spreads eight bytes' digit pairs over "xx xx xx ..."; 0x80 selects nothing, which `spaces*` then fills
+        alignas(16) inline constexpr std::uint8_t spreadFirst[16] = {
+            0, 1, 0x80, 2, 3, 0x80, 4, 5, 0x80, 6, 7, 0x80, 8, 9, 0x80, 10};
+        alignas(16) inline constexpr std::uint8_t spreadRest[16] = {
+            11, 0x80, 12, 13, 0x80, 14, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80};
+        alignas(16) inline constexpr std::uint8_t spacesFirst[16] = {
+            0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0};
+        alignas(16) inline constexpr std::uint8_t spacesRest[16] = {
+            0, ' ', 0, 0, ' ', 0, 0, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '};
+#endif
+
+#ifdef AXOLOGL_HEX_X86
+        /**
+         * Lay out one line from its digit pairs and printable bytes. The stores overlap: each one's spare spaces are
+         * overwritten by the next.
+         */
+        __attribute__((target("ssse3"))) inline void storeLine(const __m128i pairsFirst, const __m128i pairsSecond,
+                                                               const __m128i ascii, const std::uint64_t offset,
+                                                               char* out)
+        {
+            const __m128i first = _mm_load_si128(reinterpret_cast<const __m128i*>(spreadFirst));
+            const __m128i rest = _mm_load_si128(reinterpret_cast<const __m128i*>(spreadRest));
+            const __m128i fillFirst = _mm_load_si128(reinterpret_cast<const __m128i*>(spacesFirst));
+            const __m128i fillRest = _mm_load_si128(reinterpret_cast<const __m128i*>(spacesRest));
+
+            writeOffset(out, offset);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 10),
+                             _mm_or_si128(_mm_shuffle_epi8(pairsFirst, first), fillFirst));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 26),
+                             _mm_or_si128(_mm_shuffle_epi8(pairsFirst, rest), fillRest));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 35),
+                             _mm_or_si128(_mm_shuffle_epi8(pairsSecond, first), fillFirst));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 51),
+                             _mm_or_si128(_mm_shuffle_epi8(pairsSecond, rest), fillRest));
+            out[asciiColumn - 1] = '|';
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + asciiColumn), ascii);
+            out[lineLength - 1] = '|';
+        }
+
+        __attribute__((target("ssse3"))) inline void encodeLinesSsse3(const std::uint8_t* data,
+                                                                       const std::size_t lines, std::uint64_t offset,
+                                                                       char* out)
+        {
+            const __m128i lookup = _mm_loadu_si128(reinterpret_cast<const __m128i*>(digits));
+            const __m128i nibble = _mm_set1_epi8(0x0F);
+            const __m128i lowest = _mm_set1_epi8(0x1F);
+            const __m128i highest = _mm_set1_epi8(0x7F);
+            const __m128i dots = _mm_set1_epi8('.');
+
+            for (std::size_t line = 0; line < lines; line++)
+            {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+                const __m128i high = _mm_shuffle_epi8(lookup, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble));
+                const __m128i low = _mm_shuffle_epi8(lookup, _mm_and_si128(bytes, nibble));
+
+                // Signed compares: bytes from 0x80 up are negative, so fail the first one
+                const __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(bytes, lowest), _mm_cmplt_epi8(bytes, highest));
+                const __m128i ascii = _mm_or_si128(_mm_and_si128(printable, bytes), _mm_andnot_si128(printable, dots));
+
+                storeLine(_mm_unpacklo_epi8(high, low), _mm_unpackhi_epi8(high, low), ascii, offset, out);
+                if (line + 1 < lines) out[lineLength] = '\n';
+                data += bytesPerLine;
+                offset += bytesPerLine;
+                out += lineLength + 1;
+            }
+        }
+
+        // Two lines at a time, one per 128-bit lane, since the byte shuffles don't cross lanes anyway
+        __attribute__((target("avx2"))) inline void encodeLinesAvx2(const std::uint8_t* data, const std::size_t lines,
+                                                                     std::uint64_t offset, char* out)
+        {
+            const __m256i lookup = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(digits)));
+            const __m256i nibble = _mm256_set1_epi8(0x0F);
+            const __m256i lowest = _mm256_set1_epi8(0x1F);
+            const __m256i highest = _mm256_set1_epi8(0x7F);
+            const __m256i dots = _mm256_set1_epi8('.');
+
+            std::size_t line = 0;
+            for (; line + 2 <= lines; line += 2)
+            {
+                const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+                const __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble));
+                const __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(bytes, nibble));
+                const __m256i pairsFirst = _mm256_unpacklo_epi8(high, low);
+                const __m256i pairsSecond = _mm256_unpackhi_epi8(high, low);
+
+                const __m256i printable = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, lowest),
+                                                           _mm256_cmpgt_epi8(highest, bytes));
+                const __m256i ascii = _mm256_blendv_epi8(dots, bytes, printable);
+
+                storeLine(_mm256_castsi256_si128(pairsFirst), _mm256_castsi256_si128(pairsSecond),
+                          _mm256_castsi256_si128(ascii), offset, out);
+                out[lineLength] = '\n';
+                storeLine(_mm256_extracti128_si256(pairsFirst, 1), _mm256_extracti128_si256(pairsSecond, 1),
+                          _mm256_extracti128_si256(ascii, 1), offset + bytesPerLine, out + lineLength + 1);
+                if (line + 2 < lines) out[2 * lineLength + 1] = '\n';
+                data += 2 * bytesPerLine;
+                offset += 2 * bytesPerLine;
+                out += 2 * (lineLength + 1);
+            }
+            if (line < lines) encodeLinesSsse3(data, 1, offset, out);
+        }
+#endif
+
+#ifdef AXOLOGL_HEX_NEON
+        inline void encodeLinesNeon(const std::uint8_t* data, const std::size_t lines, std::uint64_t offset, char* out)
+        {
+            const uint8x16_t lookup = vld1q_u8(reinterpret_cast<const std::uint8_t*>(digits));
+            const uint8x16_t first = vld1q_u8(spreadFirst);
+            const uint8x16_t rest = vld1q_u8(spreadRest);
+            const uint8x16_t fillFirst = vld1q_u8(spacesFirst);
+            const uint8x16_t fillRest = vld1q_u8(spacesRest);
+            const uint8x16_t nibble = vdupq_n_u8(0x0F);
+            const uint8x16_t lowest = vdupq_n_u8(0x20);
+            const uint8x16_t highest = vdupq_n_u8(0x7F);
+            const uint8x16_t dots = vdupq_n_u8('.');
+
+            for (std::size_t line = 0; line < lines; line++)
+            {
+                const uint8x16_t bytes = vld1q_u8(data);
+                const uint8x16_t high = vqtbl1q_u8(lookup, vshrq_n_u8(bytes, 4));
+                const uint8x16_t low = vqtbl1q_u8(lookup, vandq_u8(bytes, nibble));
+                const uint8x16_t pairsFirst = vzip1q_u8(high, low);
+                const uint8x16_t pairsSecond = vzip2q_u8(high, low);
+                const uint8x16_t printable = vandq_u8(vcgeq_u8(bytes, lowest), vcltq_u8(bytes, highest));
+
+                // Out-of-range table indices (0x80) give 0, like `pshufb`, so the same layout works here
+                auto* target = reinterpret_cast<std::uint8_t*>(out);
+                writeOffset(out, offset);
+                vst1q_u8(target + 10, vorrq_u8(vqtbl1q_u8(pairsFirst, first), fillFirst));
+                vst1q_u8(target + 26, vorrq_u8(vqtbl1q_u8(pairsFirst, rest), fillRest));
+                vst1q_u8(target + 35, vorrq_u8(vqtbl1q_u8(pairsSecond, first), fillFirst));
+                vst1q_u8(target + 51, vorrq_u8(vqtbl1q_u8(pairsSecond, rest), fillRest));
+                out[asciiColumn - 1] = '|';
+                vst1q_u8(target + asciiColumn, vbslq_u8(printable, bytes, dots));
+                out[lineLength - 1] = '|';
+
+                if (line + 1 < lines) out[lineLength] = '\n';
+                data += bytesPerLine;
+                offset += bytesPerLine;
+                out += lineLength + 1;
+            }
+        }
+#endif
+    }
+
+    /**
+     * @return Whether `encoder` can run on this CPU
+     */
+    inline bool supported(const Encoder encoder)
+    {
+        switch (encoder)
+        {
+        case Encoder::Scalar: return true;
+#ifdef AXOLOGL_HEX_X86
+        case Encoder::Ssse3: return __builtin_cpu_init(), __builtin_cpu_supports("ssse3");
+        case Encoder::Avx2: return __builtin_cpu_init(), __builtin_cpu_supports("avx2");
+#endif
+#ifdef AXOLOGL_HEX_NEON
+        case Encoder::Neon: return true;
+#endif
+        default: return false;
+        }
+    }
+
+    /**
+     * @return The fastest encoder this CPU supports, worked out once
+     */
+    inline Encoder fastest()
+    {
+        static const Encoder encoder = supported(Encoder::Avx2) ? Encoder::Avx2
+            : supported(Encoder::Ssse3) ? Encoder::Ssse3
+            : supported(Encoder::Neon) ? Encoder::Neon
+            : Encoder::Scalar;
+        return encoder;
+    }
+
+    /**
+     * @return How many characters `encode` writes for `length` bytes: one line per 16 bytes, separated by `\n`
+     */
+    constexpr std::size_t dumpSize(const std::size_t length)
+    {
+        const std::size_t full = length / bytesPerLine;
+        const std::size_t rest = length % bytesPerLine;
+        const std::size_t lines = full + (rest != 0 ? 1 : 0);
+        return lines == 0 ? 0 : full * lineLength + (rest != 0 ? detail::asciiColumn + rest + 1 : 0) + lines - 1;
+    }
+
+    /**
+     * Encode `length` bytes into `out`, which must have room for `dumpSize(length)` characters. Offsets count from 0
+     * and show the low 32 bits.
+     *
+     * @param encoder   (Optional) Which encoder to use; it must be `supported()`
+     *
+     * @return The number of characters written
+     */
+    inline std::size_t encode(const void* data, const std::size_t length, char* out,
+                              const Encoder encoder = fastest())
+    {
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        const std::size_t full = length / bytesPerLine;
+        const std::size_t rest = length % bytesPerLine;
+
+        switch (encoder)
+        {
+#ifdef AXOLOGL_HEX_X86
+        case Encoder::Ssse3: detail::encodeLinesSsse3(bytes, full, 0, out); break;
+        case Encoder::Avx2: detail::encodeLinesAvx2(bytes, full, 0, out); break;
+#endif
+#ifdef AXOLOGL_HEX_NEON
+        case Encoder::Neon: detail::encodeLinesNeon(bytes, full, 0, out); break;
+#endif
+        default: detail::encodeLinesScalar(bytes, full, 0, out); break;
+        }
+
+        if (rest != 0)
+        {
+            char* last = out + full * (lineLength + 1);
+            if (full != 0) last[-1] = '\n';
+            detail::encodeLineScalar(bytes + full * bytesPerLine, rest, full * bytesPerLine, last);
+        }
+        return dumpSize(length);
+    }
+
+    /**
+     * Append the dump of `length` bytes to `out`, growing it once
+     */
+    inline void append(std::string& out, const void* data, const std::size_t length)
+    {
+        const std::size_t begin = out.size();
+        out.resize(begin + dumpSize(length));
+        encode(data, length, out.data() + begin);
+    }
+}
+
+namespace axologl
+{
+    /**
+     * Log a binary payload as a hex dump: a `label (N bytes)` line followed by the dump, as a single record. Nothing is
+     * encoded unless `level` is being logged.
+     *
+     * @param level     The level to log at
+     * @param data      The payload
+     * @param length    Its size in bytes
+     * @param label     (Optional) What the payload is, e.g. `"IPC reply"`
+     * @param site      (Optional) The call site, from `intern()`
+     */
+    inline void hexdump(const LogLevel level, const void* data, const std::size_t length,
+                        const std::string_view label = {}, const SiteId site = noSite)
+    {
+        Axologl* const instance = _axologl.load(std::memory_order_acquire);
+        if (instance == nullptr ? level < _logLevel.load(std::memory_order_relaxed)
+                                : !instance->getLogger(level).shouldLog())
+        {
+            Stats::add(_stats.filtered[level]);
+            return;
+        }
+
+        std::size_t encoded = length;
+        if (instance == nullptr)
+        {
+            // Only the first lines would fit in the early buffer anyway
+            encoded = std::min(length, early::textSize / (hex::lineLength + 1) * hex::bytesPerLine);
+        }
+
+        std::string text;
+        text.reserve(label.size() + 24 + 1 + hex::dumpSize(encoded));
+        text.append(label.empty() ? "Hex dump" : label);
+        text.append(" (" + std::to_string(length) + " bytes)");
+        if (encoded != 0)
+        {
+            text.push_back('\n');
+            hex::append(text, data, encoded);
+        }
+
+        if (instance == nullptr) return early::push(level, text, site);
+        instance->getLogger(level).log(text, instance->canLogToConsole(), nullptr, site);
+    }
+}
+
+#endif //AXOLOGL_HEXDUMP_H
@@ -0,0 +1,619 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_INDEX_H
+#define AXOLOGL_INDEX_H
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "compress.h"
+#include "levels.h"
+
+/*
+ * Sidecar index for log files.
+ *
+ * Alongside `axologl.log`, `axologl.log.idx` holds one fixed-size entry per block of the log: where the block sits
+ * in the file, the wall-clock time of its first and last record, its first line number and a bitmap of the levels
+ * it contains. A reader can then binary-search to a time range and skip every block that has nothing at or above
+ * the level it is interested in.
+ *
+ *     index := "AXIX" version(u8) reserved(u8) patternLength(u16) pattern(u8[patternLength]) entry*
+ *     entry := offset(u64) firstTime(u64) lastTime(u64) firstLine(u64) length(u32) lineCount(u32)
+ *              levelMask(u8) flags(u8) reserved(u8[6])
+ *
+ * All integers are little-endian and times are milliseconds since the Unix epoch. A partially written final entry is
+ * ignored. `pattern` is the file pattern the log was written with, which readers need to find each line's level (see
+ * `LevelLocator`); version 1 indexes have no pattern and a zero `patternLength`, and were always written with
+ * `defaultPattern`.
+ *
+ * This header deliberately has no libnx dependency so that it can be used by the host tools.
+ */
+namespace axologl::index
+{
+    namespace fs = std::filesystem;
+
+    inline constexpr char indexMagic[4] = {'A', 'X', 'I', 'X'};
+    inline constexpr std::uint8_t indexVersion = 2;
+    inline constexpr std::size_t indexHeaderSize = 8;
+    inline constexpr std::size_t entrySize = 48;
+
+    // Plain-text logs are checkpointed every this many bytes; compressed logs once per compressed block
+    inline constexpr std::size_t blockInterval = 64 * 1024;
+
+    inline constexpr std::uint8_t compressedBlock = 1 << 0;
+
+    struct Entry
+    {
+        std::uint64_t offset = 0;
+        std::uint64_t firstTime = 0;
+        std::uint64_t lastTime = 0;
+        std::uint64_t firstLine = 0;
+        std::uint32_t length = 0;
+        std::uint32_t lineCount = 0;
+        std::uint8_t levelMask = 0;
+        std::uint8_t flags = 0;
+
+        /**
+         * @return Whether the block holds any record at or above `level`
+         */
+        [[nodiscard]] bool hasLevelAtLeast(const LogLevel level) const
+        {
+            return (levelMask >> level) != 0;
+        }
+    };
+
+    namespace detail
+    {
+        inline void writeLE(char* p, std::uint64_t value, const std::size_t size)
+        {
+            for (std::size_t i = 0; i < size; i++, value >>= 8)
+            {
+                p[i] = static_cast<char>(value & 0xFF);
+            }
+        }
+
+        inline std::uint64_t readLE(const char* p, const std::size_t size)
+        {
+            std::uint64_t value = 0;
+            for (std::size_t i = size; i-- > 0;)
+            {
+                value = value << 8 | static_cast<unsigned char>(p[i]);
+            }
+            return value;
+        }
+
+        inline void encode(const Entry& entry, char* out)
+        {
+            std::fill(out, out + entrySize, 0);
+            writeLE(out, entry.offset, 8);
+            writeLE(out + 8, entry.firstTime, 8);
+            writeLE(out + 16, entry.lastTime, 8);
+            writeLE(out + 24, entry.firstLine, 8);
+            writeLE(out + 32, entry.length, 4);
+            writeLE(out + 36, entry.lineCount, 4);
+            out[40] = static_cast<char>(entry.levelMask);
+            out[41] = static_cast<char>(entry.flags);
+        }
+
+        inline Entry decode(const char* in)
+        {
+            Entry entry;
+            entry.offset = readLE(in, 8);
+            entry.firstTime = readLE(in + 8, 8);
+            entry.lastTime = readLE(in + 16, 8);
+            entry.firstLine = readLE(in + 24, 8);
+            entry.length = static_cast<std::uint32_t>(readLE(in + 32, 4));
+            entry.lineCount = static_cast<std::uint32_t>(readLE(in + 36, 4));
+            entry.levelMask = static_cast<std::uint8_t>(in[40]);
+            entry.flags = static_cast<std::uint8_t>(in[41]);
+            return entry;
+        }
+
+        inline std::uint64_t wallClockMs()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+    }
+
+    /**
+     * @return Where the index for `logPath` lives
+     */
+    inline fs::path indexPathFor(const fs::path& logPath)
+    {
+        fs::path path = logPath;
+        path += ".idx";
+        return path;
+    }
+
+    /**
+     * Read every complete entry of an index file
+     *
+     * @param pattern   Set to the file pattern the log was written with
+     *
+     * @return false if the file is missing or is not an index
+     */
+    inline bool readIndex(const fs::path& path, std::vector<Entry>& entries, std::string& pattern)
+    {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        char header[indexHeaderSize];
+        bool valid = fread(header, 1, indexHeaderSize, file) == indexHeaderSize
+            && std::equal(indexMagic, indexMagic + sizeof(indexMagic), header)
+            && static_cast<std::uint8_t>(header[4]) <= indexVersion;
+
+        pattern = defaultPattern;
+        if (valid && static_cast<std::uint8_t>(header[4]) >= 2)
+        {
+            pattern.resize(detail::readLE(header + 6, 2));
+            valid = fread(pattern.data(), 1, pattern.size(), file) == pattern.size();
+        }
+
+        char raw[entrySize];
+        while (valid && fread(raw, 1, entrySize, file) == entrySize)
+        {
+            entries.push_back(detail::decode(raw));
+        }
+
+        fclose(file);
+        return valid;
+    }
+
+    /**
+     * Maintains the index as `FileLogger` writes. Not thread-safe; the owning logger serialises access.
+     */
+    class IndexWriter
+    {
+        FILE* file = nullptr;
+        Entry current;
+        bool blockOpen = false;
+        std::uint64_t nextLine = 0;
+        std::uint64_t lastTime = 0;
+        // Where the last entry of the previous session ends in the log file
+        std::uint64_t indexedEnd = 0;
+        bool plainText = true;
+
+    public:
+        /**
+         * @param path      Where the index lives
+         * @param pattern   The file pattern the log is written with
+         */
+        explicit IndexWriter(const fs::path& path, const std::string_view pattern = defaultPattern)
+        {
+            // Line numbers carry on from the previous session. An index for another pattern can't describe lines
+            // written with this one, so it is started again and the whole log counts as unindexed.
+            std::vector<Entry> existing;
+            std::string existingPattern;
+            const bool valid = readIndex(path, existing, existingPattern) && existingPattern == pattern;
+            if (!valid) existing.clear();
+            if (!existing.empty())
+            {
+                const Entry& last = existing.back();
+                nextLine = last.firstLine + last.lineCount;
+                lastTime = last.lastTime;
+                indexedEnd = last.offset + last.length;
+                plainText = (last.flags & compressedBlock) == 0;
+            }
+
+            file = fopen(path.c_str(), valid ? "ab" : "wb");
+            if (file != nullptr && !valid)
+            {
+                char header[indexHeaderSize] = {
+                    indexMagic[0], indexMagic[1], indexMagic[2], indexMagic[3], static_cast<char>(indexVersion), 0, 0, 0
+                };
+                detail::writeLE(header + 6, pattern.size(), 2);
+                fwrite(header, 1, indexHeaderSize, file);
+                fwrite(pattern.data(), 1, pattern.size(), file);
+                fflush(file);
+            }
+        }
+
+        ~IndexWriter()
+        {
+            if (file != nullptr) fclose(file);
+        }
+
+        IndexWriter(const IndexWriter&) = delete;
+        IndexWriter& operator=(const IndexWriter&) = delete;
+
+        [[nodiscard]] bool ready() const
+        {
+            return file != nullptr;
+        }
+
+        [[nodiscard]] bool hasOpenBlock() const
+        {
+            return blockOpen;
+        }
+
+        /**
+         * Index the part of a plain-text log that was written after the last entry but never indexed, e.g. the
+         * checkpoint a crash cut short. Levels and times aren't known, so the entries claim every level and the time
+         * from the last entry until now.
+         *
+         * @param log   The log file, open for reading
+         * @param end   Its current size
+         */
+        void indexUnindexed(FILE* log, const std::uint64_t end)
+        {
+            if (!plainText || indexedEnd >= end || fseek(log, static_cast<long>(indexedEnd), SEEK_SET) != 0)
+            {
+                return;
+            }
+
+            const std::uint64_t now = detail::wallClockMs();
+            std::vector<char> chunk(blockInterval);
+            for (std::uint64_t begin = indexedEnd; begin < end;)
+            {
+                const std::size_t want = std::min<std::uint64_t>(blockInterval, end - begin);
+                const std::size_t size = fread(chunk.data(), 1, want, log);
+                if (size == 0) break;
+
+                current = Entry{};
+                current.firstTime = lastTime != 0 ? lastTime : now;
+                current.lastTime = now;
+                current.firstLine = nextLine;
+                current.lineCount = static_cast<std::uint32_t>(std::count(chunk.data(), chunk.data() + size, '\n'));
+                current.levelMask = 0xFF;
+                nextLine += current.lineCount;
+                blockOpen = true;
+                closeBlock(begin, begin + size, false);
+                begin += size;
+            }
+            lastTime = now;
+            fseek(log, 0, SEEK_END);
+        }
+
+        /**
+         * Note a record, or a batch of records, about to be written to the current block
+         *
+         * @param first   When the first record in `text` was logged, in milliseconds since the Unix epoch
+         * @param last    When the last one was
+         */
+        void addRecord(const LogLevel level, const std::string_view text, const std::uint64_t first,
+                       const std::uint64_t last)
+        {
+            const std::uint64_t earliest = std::min(first, last);
+            const std::uint64_t latest = std::max(first, last);
+            if (!blockOpen)
+            {
+                current = Entry{};
+                current.firstTime = earliest;
+                current.lastTime = latest;
+                current.firstLine = nextLine;
+                blockOpen = true;
+            }
+
+            // Replayed records can be older than the ones before them; the bounds must still cover them
+            lastTime = last;
+            const auto lines = static_cast<std::uint32_t>(std::count(text.begin(), text.end(), '\n') + 1);
+            current.firstTime = std::min(current.firstTime, earliest);
+            current.lastTime = std::max(current.lastTime, latest);
+            current.lineCount += lines;
+            current.levelMask |= static_cast<std::uint8_t>(1u << level);
+            nextLine += lines;
+        }
+
+        /**
+         * End the current block, which occupies [begin, end) of the log file. A block holding only the tail of an
+         * oversized record still gets an entry so that readers can follow the record into it.
+         *
+         * @return The block's entry, to be written with `writeEntry()` once the block itself is in the file
+         */
+        Entry finishBlock(const std::uint64_t begin, const std::uint64_t end, const bool compressed)
+        {
+            if (!blockOpen)
+            {
+                current = Entry{};
+                current.firstTime = current.lastTime = lastTime;
+                current.firstLine = nextLine;
+            }
+            current.offset = begin;
+            current.length = static_cast<std::uint32_t>(end - begin);
+            current.flags = compressed ? compressedBlock : 0;
+            blockOpen = false;
+            return current;
+        }
+
+        /**
+         * Append an entry from `finishBlock()` to the index. Only touches the index file, so it may run on another
+         * thread than the one adding records.
+         */
+        void writeEntry(const Entry& entry)
+        {
+            if (file != nullptr)
+            {
+                char raw[entrySize];
+                detail::encode(entry, raw);
+                fwrite(raw, 1, entrySize, file);
+                fflush(file);
+            }
+        }
+
+        /**
+         * Write out the entry for the block occupying [begin, end) of the log file, which must already be there
+         */
+        void closeBlock(const std::uint64_t begin, const std::uint64_t end, const bool compressed)
+        {
+            writeEntry(finishBlock(begin, end, compressed));
+        }
+    };
+
+    /**
+     * @struct Query
+     *
+     * @brief Which lines an `IndexedLog` query should return
+     *
+     * @param since     Earliest time of interest, in milliseconds since the Unix epoch
+     * @param until     Latest time of interest, in milliseconds since the Unix epoch
+     * @param minLevel  Lowest level to return
+     */
+    struct Query
+    {
+        std::uint64_t since = 0;
+        std::uint64_t until = UINT64_MAX;
+        LogLevel minLevel = Debug;
+    };
+
+    struct QueryStats
+    {
+        std::size_t blocksRead = 0;
+        std::size_t blocksSkipped = 0;
+        std::size_t blocksDamaged = 0;
+        std::uint64_t bytesRead = 0;
+    };
+
+    /**
+     * Answers filtered queries against a log file using its sidecar index. Times are only known per block, so a
+     * time range returns every line of the indexed blocks that overlap it. Lines past the index are filtered by their
+     * own `%T` time instead, when the file pattern has one ahead of `%L`.
+     */
+    class IndexedLog
+    {
+        FILE* file = nullptr;
+        std::vector<Entry> entries;
+        LevelLocator levels;
+        compress::FrameReader frames{nullptr};
+        std::string block;
+        std::string carry;
+        LogLevel level = Raw;
+        bool levelKnown = false;
+        // Set while scanning the tail, whose lines are filtered by their own time
+        const Query* timeFilter = nullptr;
+        bool inRange = true;
+
+        bool readBlock(const Entry& entry)
+        {
+            if (fseek(file, static_cast<long>(entry.offset), SEEK_SET) != 0)
+            {
+                return false;
+            }
+
+            if ((entry.flags & compressedBlock) != 0)
+            {
+                return frames.readBlock(block);
+            }
+
+            block.resize(entry.length);
+            return fread(block.data(), 1, entry.length, file) == entry.length;
+        }
+
+        /**
+         * Hand every complete line of `text` that passes the level filter to `onLine`, keeping any trailing partial
+         * line in `carry` for the next block
+         */
+        template <typename Callback>
+        void emitLines(std::string_view text, const LogLevel minLevel, Callback& onLine)
+        {
+            while (!text.empty())
+            {
+                const std::size_t newline = text.find('\n');
+                if (newline == std::string_view::npos)
+                {
+                    carry.append(text);
+                    return;
+                }
+
+                std::string_view line = text.substr(0, newline);
+                if (!carry.empty())
+                {
+                    carry.append(line);
+                    line = carry;
+                }
+                emitLine(line, minLevel, onLine);
+                carry.clear();
+                text.remove_prefix(newline + 1);
+            }
+        }
+
+        template <typename Callback>
+        void emitLine(const std::string_view line, const LogLevel minLevel, Callback& onLine)
+        {
+            // Lines without a prefix continue the previous record, whose level and time are unknown after a skipped
+            // block. A record without a readable time is kept.
+            std::uint64_t time = 0;
+            if (levels.find(line, level, timeFilter != nullptr ? &time : nullptr))
+            {
+                levelKnown = true;
+                inRange = timeFilter == nullptr || time == 0
+                    || (time >= timeFilter->since && time <= timeFilter->until);
+            }
+            if (levelKnown && inRange && level >= minLevel)
+            {
+                onLine(line, level);
+            }
+        }
+
+        /**
+         * Read whatever was written after the last indexed block: the block still being filled, or the one that was
+         * lost to a crash
+         */
+        template <typename Callback>
+        void scanTail(const Query& query, QueryStats& stats, Callback& onLine)
+        {
+            const LogLevel minLevel = query.minLevel;
+            bool compressed = false;
+            std::uint64_t offset = 0;
+            if (!entries.empty())
+            {
+                compressed = (entries.back().flags & compressedBlock) != 0;
+                offset = entries.back().offset + entries.back().length;
+            }
+            else
+            {
+                char magic[sizeof(compress::frameMagic)] = {};
+                rewind(file);
+                compressed = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+                    && std::equal(magic, magic + sizeof(magic), compress::frameMagic);
+            }
+
+            if (fseek(file, static_cast<long>(offset), SEEK_SET) != 0)
+            {
+                return;
+            }
+
+            if (compressed)
+            {
+                while (frames.next(block))
+                {
+                    stats.blocksRead++;
+                    stats.bytesRead += block.size();
+                    emitLines(block, minLevel, onLine);
+                }
+                return;
+            }
+
+            block.resize(blockInterval);
+            std::size_t got;
+            while ((got = fread(block.data(), 1, block.size(), file)) > 0)
+            {
+                stats.blocksRead++;
+                stats.bytesRead += got;
+                emitLines(std::string_view(block.data(), got), minLevel, onLine);
+            }
+        }
+
+    public:
+        explicit IndexedLog(const fs::path& logPath)
+        {
+            std::string pattern;
+            if (!readIndex(indexPathFor(logPath), entries, pattern))
+            {
+                return;
+            }
+            levels = LevelLocator(pattern);
+
+            file = fopen(logPath.c_str(), "rb");
+            frames = compress::FrameReader(file);
+        }
+
+        ~IndexedLog()
+        {
+            if (file != nullptr) fclose(file);
+        }
+
+        IndexedLog(const IndexedLog&) = delete;
+        IndexedLog& operator=(const IndexedLog&) = delete;
+
+        [[nodiscard]] bool ready() const
+        {
+            return file != nullptr;
+        }
+
+        [[nodiscard]] const std::vector<Entry>& getEntries() const
+        {
+            return entries;
+        }
+
+        /**
+         * Run a query, calling `onLine(std::string_view line, LogLevel level)` for every matching line in file order
+         */
+        template <typename Callback>
+        QueryStats query(const Query& query, Callback&& onLine)
+        {
+            QueryStats stats;
+            if (file == nullptr)
+            {
+                return stats;
+            }
+
+            // Blocks are appended in time order, so the first one that could match is found by binary search
+            const auto first = std::partition_point(entries.begin(), entries.end(), [&query](const Entry& entry) {
+                return entry.lastTime < query.since;
+            });
+            stats.blocksSkipped = first - entries.begin();
+
+            frames = compress::FrameReader(file);
+            carry.clear();
+            levelKnown = false;
+            timeFilter = nullptr;
+            inRange = true;
+            auto it = first;
+            for (; it != entries.end() && it->firstTime <= query.until; ++it)
+            {
+                // A record running over from the previous block must be finished even if this block would be skipped
+                if (!it->hasLevelAtLeast(query.minLevel) && carry.empty())
+                {
+                    stats.blocksSkipped++;
+                    levelKnown = false;
+                    continue;
+                }
+                if (!readBlock(*it))
+                {
+                    // Cut short by a crash; later sessions are still intact
+                    stats.blocksDamaged++;
+                    carry.clear();
+                    levelKnown = false;
+                    continue;
+                }
+
+                stats.blocksRead++;
+                stats.bytesRead += it->length;
+                emitLines(block, query.minLevel, onLine);
+            }
+
+            // Anything newer than the index can only be found by scanning it, unless the range ended before the
+            // last indexed block began
+            if (it == entries.end())
+            {
+                timeFilter = &query;
+                scanTail(query, stats, onLine);
+            }
+
+            if (!carry.empty())
+            {
+                emitLine(carry, query.minLevel, onLine);
+                carry.clear();
+            }
+            timeFilter = nullptr;
+            return stats;
+        }
+    };
+}
+
+#endif //AXOLOGL_INDEX_H
@@ -0,0 +1,237 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_LAYOUT_H
+#define AXOLOGL_LAYOUT_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "levels.h"
+#include "location.h"
+
+namespace axologl
+{
+    /**
+     * @struct Record
+     *
+     * @brief One message on its way to the sinks, before layout
+     *
+     * @param level     The level it was logged at
+     * @param message   The text passed by the caller
+     * @param site      Where it was logged from, or `noSite`
+     * @param time      Wall-clock time in milliseconds since the Unix epoch
+     * @param thread    A small per-thread number, in order of each thread's first record
+     */
+    struct Record
+    {
+        LogLevel level = Raw;
+        std::string_view message;
+        SiteId site = noSite;
+        std::uint64_t time = 0;
+        std::uint32_t thread = 0;
+    };
+
+    inline std::uint64_t wallClockMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    inline std::uint32_t currentThreadId()
+    {
+        static std::atomic<std::uint32_t> threadCount{0};
+        thread_local const std::uint32_t id = threadCount.fetch_add(1, std::memory_order_relaxed) + 1;
+        return id;
+    }
+
+    /**
+     * A pattern compiled for one level. Fields:
+     *
+     * - `%T` Local time, `2026-01-31 18:04:05.123`
+     * - `%t` Thread number
+     * - `%L` Level prefix, e.g. `WARN`
+     * - `%m` Message
+     * - `%s` Call site, `file.cpp:42 in function` (empty for records without one)
+     * - `%%` A literal `%`
+     *
+     * Everything that doesn't change between records of the same level (literal text, the prefix and any ANSI colour)
+     * is folded into constant fragments when the pattern is compiled, so rendering only appends fragments and fills
+     * in the fields the pattern actually uses. A pattern without `%s` gets the call site appended as ` (...)` when
+     * there is one.
+     */
+    class Layout
+    {
+        enum class Field : std::uint8_t
+        {
+            Literal,
+            Message,
+            Time,
+            Thread,
+            Source,
+            SourceSuffix
+        };
+
+        struct Op
+        {
+            Field field;
+            std::string literal;
+        };
+
+        std::vector<Op> ops = {{Field::Message, {}}};
+
+        void addLiteral(const std::string_view text)
+        {
+            if (text.empty()) return;
+            if (!ops.empty() && ops.back().field == Field::Literal)
+            {
+                ops.back().literal.append(text);
+            }
+            else
+            {
+                ops.push_back({Field::Literal, std::string(text)});
+            }
+        }
+
+        static void appendTime(std::string& out, const std::uint64_t ms)
+        {
+            // Records come in bursts, so the date and time are only reformatted when the second changes
+            thread_local std::uint64_t cachedSecond = UINT64_MAX;
+            thread_local char cached[24];
+            thread_local std::size_t cachedLength = 0;
+
+            const std::uint64_t second = ms / 1000;
+            if (second != cachedSecond)
+            {
+                const std::time_t seconds = static_cast<std::time_t>(second);
+                std::tm parts{};
+                localtime_r(&seconds, &parts);
+                cachedLength = std::strftime(cached, sizeof(cached), "%Y-%m-%d %H:%M:%S", &parts);
+                cachedSecond = second;
+            }
+
+            const unsigned millis = static_cast<unsigned>(ms % 1000);
+            const char fraction[4] = {'.', static_cast<char>('0' + millis / 100),
+                                      static_cast<char>('0' + millis / 10 % 10), static_cast<char>('0' + millis % 10)};
+            out.append(cached, cachedLength);
+            out.append(fraction, sizeof(fraction));
+        }
+
+    public:
+        /**
+         * Renders the bare message
+         */
+        Layout() = default;
+
+        /**
+         * @param pattern   See the class description
+         * @param prefix    The level's prefix, substituted for `%L`
+         * @param ansiCode  (Optional) An ANSI colour to wrap the whole line in
+         */
+        Layout(const std::string_view pattern, const std::string_view prefix, const std::string_view ansiCode = {})
+        {
+            ops.clear();
+            addLiteral(ansiCode);
+            bool hasSource = false;
+            std::string literal;
+            for (std::size_t i = 0; i < pattern.size(); i++)
+            {
+                if (pattern[i] != '%' || i + 1 == pattern.size())
+                {
+                    literal.push_back(pattern[i]);
+                    continue;
+                }
+
+                Field field = Field::Literal;
+                switch (pattern[++i])
+                {
+                case 'L': literal.append(prefix); break;
+                case '%': literal.push_back('%'); break;
+                case 'm': field = Field::Message; break;
+                case 'T': field = Field::Time; break;
+                case 't': field = Field::Thread; break;
+                case 's': field = Field::Source; hasSource = true; break;
+                default:
+                    // Unknown fields are kept as written so that mistakes are visible in the output
+                    literal.push_back('%');
+                    literal.push_back(pattern[i]);
+                    break;
+                }
+
+                if (field != Field::Literal)
+                {
+                    addLiteral(literal);
+                    literal.clear();
+                    ops.push_back({field, {}});
+                }
+            }
+            addLiteral(literal);
+            if (!hasSource) ops.push_back({Field::SourceSuffix, {}});
+            if (!ansiCode.empty()) addLiteral("\033[0m");
+        }
+
+        /**
+         * Append `record` to `out` as laid out by this pattern
+         *
+         * @param showSource    Whether to render call sites at all
+         * @param shortPaths    Whether call sites show just the file's name
+         * @param timeFields    (Optional) Receives where each `%T` starts in `out`, for lines rendered ahead of time
+         *                      and stamped with the time later (see `crash.h`)
+         */
+        void render(const Record& record, std::string& out, const bool showSource, const bool shortPaths,
+                    std::vector<std::size_t>* timeFields = nullptr) const
+        {
+            for (const Op& op : ops)
+            {
+                switch (op.field)
+                {
+                case Field::Literal:
+                    out.append(op.literal);
+                    break;
+                case Field::Message:
+                    out.append(record.message);
+                    break;
+                case Field::Time:
+                    if (timeFields != nullptr) timeFields->push_back(out.size());
+                    appendTime(out, record.time);
+                    break;
+                case Field::Thread:
+                    out.append(std::to_string(record.thread));
+                    break;
+                case Field::Source:
+                    if (showSource) appendSite(out, record.site, shortPaths);
+                    break;
+                case Field::SourceSuffix:
+                    if (showSource && lookupSite(record.site) != nullptr)
+                    {
+                        out.append(" (");
+                        appendSite(out, record.site, shortPaths);
+                        out.push_back(')');
+                    }
+                    break;
+                }
+            }
+        }
+    };
+}
+
+#endif //AXOLOGL_LAYOUT_H
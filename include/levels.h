@@ -0,0 +1,287 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_LEVELS_H
+#define AXOLOGL_LEVELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Kept free of libnx so that the host tools can share it
+namespace axologl
+{
+    enum LogLevel
+    {
+        Debug,
+        Info,
+        Notice,
+        Warning,
+        Error,
+        Fatal,
+        Raw
+    };
+
+    /**
+     * The destinations a message can be written to
+     */
+    enum Sink
+    {
+        File,
+        Stdout,
+        Stderr
+    };
+
+    static constexpr std::size_t levelCount = Raw + 1;
+    static constexpr std::size_t sinkCount = Stderr + 1;
+
+    /**
+     * The prefixes each level's logger writes, indexed by `LogLevel`
+     */
+    inline constexpr std::string_view levelPrefixes[] = {"DEBUG", "INFO", "NOTICE", "WARN", "ERROR", "FATAL", "RAW"};
+
+    // Reproduces the fixed `[PREFIX] text` format from before layouts could be configured
+    inline constexpr std::string_view defaultPattern = "[%L] %m";
+
+    /**
+     * Work out which level wrote a line from its `[PREFIX]`
+     *
+     * @param line  A line as written to the log file
+     * @param level Set to the line's level if it has a known prefix
+     *
+     * @return Whether the line starts with a known prefix
+     */
+    inline bool levelFromLine(const std::string_view line, LogLevel& level)
+    {
+        if (line.size() < 3 || line[0] != '[')
+        {
+            return false;
+        }
+
+        const std::size_t close = line.find(']');
+        if (close == std::string_view::npos)
+        {
+            return false;
+        }
+
+        const std::string_view prefix = line.substr(1, close - 1);
+        for (int i = Debug; i <= Raw; i++)
+        {
+            if (prefix == levelPrefixes[i])
+            {
+                level = static_cast<LogLevel>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Works out which level wrote a line of a log file from the file pattern it was written with (see `Layout`).
+     * Only the part of the pattern up to `%L` is matched, so it may hold literal text, `%T` and `%t` but not `%m` or
+     * `%s`, whose text could be anything. A pattern without `%L`, or with the message ahead of it, can't be read
+     * back and `readable()` is false.
+     */
+    class LevelLocator
+    {
+        enum class Field : std::uint8_t
+        {
+            Literal,
+            Time,
+            Thread
+        };
+
+        struct Step
+        {
+            Field field;
+            std::string literal;
+        };
+
+        // What `%T` renders, with `0` standing for any digit
+        static constexpr std::string_view timeShape = "0000-00-00 00:00:00.000";
+
+        std::vector<Step> steps;
+        // The literal text right after `%L`, which tells `INFO` apart from the start of a longer word
+        std::string after;
+        bool found = false;
+
+        static bool startsWith(const std::string_view line, const std::size_t at, const std::string_view text)
+        {
+            return at <= line.size() && line.size() - at >= text.size() && line.substr(at, text.size()) == text;
+        }
+
+        static bool isDigit(const char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        static int digits(const std::string_view text, const std::size_t at, const std::size_t count)
+        {
+            int value = 0;
+            for (std::size_t i = at; i < at + count; i++)
+            {
+                value = value * 10 + (text[i] - '0');
+            }
+            return value;
+        }
+
+        /**
+         * @param time  A `%T` field, already matched against `timeShape`
+         *
+         * @return Its local time in milliseconds since the Unix epoch, or 0 if it can't be converted
+         */
+        static std::uint64_t parseTime(const std::string_view time)
+        {
+            std::tm parts{};
+            parts.tm_year = digits(time, 0, 4) - 1900;
+            parts.tm_mon = digits(time, 5, 2) - 1;
+            parts.tm_mday = digits(time, 8, 2);
+            parts.tm_hour = digits(time, 11, 2);
+            parts.tm_min = digits(time, 14, 2);
+            parts.tm_sec = digits(time, 17, 2);
+            parts.tm_isdst = -1;
+            const std::time_t seconds = std::mktime(&parts);
+            if (seconds < 0) return 0;
+            return static_cast<std::uint64_t>(seconds) * 1000 + digits(time, 20, 3);
+        }
+
+        void addLiteral(const std::string_view text)
+        {
+            if (found)
+            {
+                after.append(text);
+            }
+            else if (!steps.empty() && steps.back().field == Field::Literal)
+            {
+                steps.back().literal.append(text);
+            }
+            else
+            {
+                steps.push_back({Field::Literal, std::string(text)});
+            }
+        }
+
+    public:
+        /**
+         * @param pattern   The file pattern the lines were written with
+         */
+        explicit LevelLocator(const std::string_view pattern = defaultPattern)
+        {
+            for (std::size_t i = 0; i < pattern.size(); i++)
+            {
+                if (pattern[i] != '%' || i + 1 == pattern.size())
+                {
+                    addLiteral(pattern.substr(i, 1));
+                    continue;
+                }
+
+                const char field = pattern[++i];
+                if (found)
+                {
+                    // `after` ends at the next field
+                    if (field != '%' && field != 'L' && field != 'm' && field != 'T' && field != 't' && field != 's')
+                    {
+                        addLiteral(pattern.substr(i - 1, 2));
+                        continue;
+                    }
+                    if (field != '%') break;
+                    addLiteral("%");
+                    continue;
+                }
+
+                switch (field)
+                {
+                case 'L': found = true; break;
+                case '%': addLiteral("%"); break;
+                case 'T': steps.push_back({Field::Time, {}}); break;
+                case 't': steps.push_back({Field::Thread, {}}); break;
+                // Nothing after the message or call site can be told apart from them
+                case 'm':
+                case 's': return;
+                default: addLiteral(pattern.substr(i - 1, 2)); break;
+                }
+            }
+        }
+
+        /**
+         * @return Whether lines written with the pattern carry a level that can be found
+         */
+        [[nodiscard]] bool readable() const
+        {
+            return found;
+        }
+
+        /**
+         * @param line  A line as written to the log file
+         * @param level Set to the line's level if it starts the way the pattern does
+         * @param time  If given, set to the time of the line's first `%T` field in milliseconds since the Unix epoch,
+         *              or 0 if the pattern has none ahead of `%L`
+         *
+         * @return Whether the line starts a record; lines that don't continue the one before them
+         */
+        bool find(const std::string_view line, LogLevel& level, std::uint64_t* time = nullptr) const
+        {
+            if (!found) return false;
+
+            std::size_t at = 0;
+            std::size_t timeAt = std::string_view::npos;
+            for (const Step& step : steps)
+            {
+                switch (step.field)
+                {
+                case Field::Literal:
+                    if (!startsWith(line, at, step.literal)) return false;
+                    at += step.literal.size();
+                    break;
+                case Field::Time:
+                    if (line.size() - at < timeShape.size()) return false;
+                    if (timeAt == std::string_view::npos) timeAt = at;
+                    for (std::size_t i = 0; i < timeShape.size(); i++, at++)
+                    {
+                        if (timeShape[i] == '0' ? !isDigit(line[at]) : line[at] != timeShape[i]) return false;
+                    }
+                    break;
+                case Field::Thread:
+                    if (at == line.size() || !isDigit(line[at])) return false;
+                    while (at < line.size() && isDigit(line[at])) at++;
+                    break;
+                }
+            }
+
+            for (int i = Debug; i <= Raw; i++)
+            {
+                const std::string_view prefix = levelPrefixes[i];
+                if (startsWith(line, at, prefix) && startsWith(line, at + prefix.size(), after))
+                {
+                    level = static_cast<LogLevel>(i);
+                    if (time != nullptr)
+                    {
+                        *time = timeAt == std::string_view::npos ? 0 : parseTime(line.substr(timeAt, timeShape.size()));
+                    }
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+}
+
+#endif //AXOLOGL_LEVELS_H
@@ -0,0 +1,156 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_LOCATION_H
+#define AXOLOGL_LOCATION_H
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+/*
+ * Call-site interning. Each `AXOLOGL_WARN(...)`-style call site registers its file, line and function once, the first
+ * time it runs, and from then on a record only carries the resulting small integer. Nothing is copied or formatted
+ * until a text sink asks for the location.
+ */
+namespace axologl
+{
+    using SiteId = std::uint32_t;
+
+    // The ID of "no known call site"; records logged through the plain functions carry it
+    inline constexpr SiteId noSite = 0;
+
+    /**
+     * @struct SourceSite
+     *
+     * @param file      `__FILE__` as the compiler gave it
+     * @param shortFile `file` with its directories trimmed, pointing into the same string
+     * @param line      `__LINE__`
+     * @param function  `__func__`
+     */
+    struct SourceSite
+    {
+        const char* file = "";
+        const char* shortFile = "";
+        std::uint32_t line = 0;
+        const char* function = "";
+    };
+
+    namespace detail
+    {
+        // Sites past this are still logged, just without a location
+        inline constexpr std::size_t maxSites = 4096;
+
+        inline std::array<SourceSite, maxSites> sites{};
+        inline std::atomic<SiteId> siteCount{0};
+        inline std::mutex siteMutex;
+
+        inline const char* trimDirectories(const char* path)
+        {
+            const char* name = path;
+            for (const char* p = path; *p != '\0'; p++)
+            {
+                if (*p == '/' || *p == '\\') name = p + 1;
+            }
+            return name;
+        }
+    }
+
+    /**
+     * Register a call site. The logging macros call this once per site, from a function-local static.
+     *
+     * @return The site's ID, or `noSite` if the table is full
+     */
+    inline SiteId intern(const char* file, const std::uint32_t line, const char* function)
+    {
+        std::lock_guard lock(detail::siteMutex);
+        const SiteId count = detail::siteCount.load(std::memory_order_relaxed);
+        if (count == detail::maxSites)
+        {
+            return noSite;
+        }
+
+        detail::sites[count] = {file, detail::trimDirectories(file), line, function};
+        // Publishes the entry to `lookupSite` on other threads
+        detail::siteCount.store(count + 1, std::memory_order_release);
+        return count + 1;
+    }
+
+    /**
+     * @return The site behind `id`, or `nullptr` for `noSite`
+     */
+    inline const SourceSite* lookupSite(const SiteId id)
+    {
+        if (id == noSite || id > detail::siteCount.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        return &detail::sites[id - 1];
+    }
+
+    /**
+     * Append `file:line in function` for `id` to `out`; does nothing for `noSite`
+     *
+     * @param shortPath Whether to print just the file's name rather than the path it was compiled with
+     */
+    inline void appendSite(std::string& out, const SiteId id, const bool shortPath)
+    {
+        const SourceSite* site = lookupSite(id);
+        if (site == nullptr)
+        {
+            return;
+        }
+
+        out.append(shortPath ? site->shortFile : site->file);
+        out.push_back(':');
+        out.append(std::to_string(site->line));
+        out.append(" in ");
+        out.append(site->function);
+    }
+}
+
+#ifdef AXOLOGL_DISABLE_SOURCE_LOCATION
+#define AXOLOGL_SITE_ID_ ::axologl::noSite
+#define AXOLOGL_DECLARE_SITE_
+#else
+#define AXOLOGL_SITE_ID_ axologlSite_
+#define AXOLOGL_DECLARE_SITE_ static const ::axologl::SiteId axologlSite_ = ::axologl::intern(__FILE__, __LINE__, __func__)
+#endif
+
+// A block rather than a lambda so that `__func__` names the caller
+#define AXOLOGL_LOG_AT_(function, text)                                                                               \
+    do                                                                                                                \
+    {                                                                                                                 \
+        AXOLOGL_DECLARE_SITE_;                                                                                        \
+        ::axologl::function(text, AXOLOGL_SITE_ID_);                                                                  \
+    }                                                                                                                 \
+    while (false)
+
+/**
+ * Log with the call site's file, line and function attached. Defining `AXOLOGL_DISABLE_SOURCE_LOCATION` makes these
+ * the same as the plain functions.
+ */
+#define AXOLOGL_DEBUG(text) AXOLOGL_LOG_AT_(debug, text)
+#define AXOLOGL_INFO(text) AXOLOGL_LOG_AT_(info, text)
+#define AXOLOGL_NOTICE(text) AXOLOGL_LOG_AT_(notice, text)
+#define AXOLOGL_WARN(text) AXOLOGL_LOG_AT_(warn, text)
+#define AXOLOGL_ERROR(text) AXOLOGL_LOG_AT_(error, text)
+#define AXOLOGL_FATAL(text) AXOLOGL_LOG_AT_(fatal, text)
+
+#endif //AXOLOGL_LOCATION_H
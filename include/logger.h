@@ -19,71 +19,232 @@
 #ifndef AXOLOGL_LOGGER_H
 #define AXOLOGL_LOGGER_H
 
+#include "channel.h"
+#include "console.h"
 #include "file.h"
+#include <atomic>
 #include <iostream>
+#include <mutex>
 #include <string>
 
 #include <types.h>
+#include "layout.h"
+#include "location.h"
+#include "overload.h"
+#include "sanitize.h"
+#include "stats.h"
 
 namespace axologl
 {
-    extern bool _ansi;
-    extern LogLevel _logLevel;
+    extern std::atomic<bool> _ansi;
+    extern std::atomic<LogLevel> _logLevel;
     extern std::unique_ptr<FileLogger> _fileLogger;
+    extern std::unique_ptr<LogTail> _tail;
+    extern SharedChannel* _channel;
+    extern std::atomic<bool> _sourceLocation;
+    extern std::atomic<bool> _shortSourcePaths;
+    extern std::atomic<bool> _sanitizeConsole;
+    extern std::atomic<bool> _sanitizeFile;
+    extern std::atomic<bool> _asyncConsole;
+
+    class Batch;
 
     class Logger
     {
+        friend class Batch;
+
         static constexpr std::string_view ansiReset = "\033[0m";
 
-        void format(std::string& text)
+        // Held while writing to the console so that records from different threads never interleave
+        static inline std::mutex consoleMutex;
+        // Used instead with `AxologlOptions::asyncConsole`; see `console.h`
+        static inline ConsoleWriter consoleWriter;
+
+        // Overload handling; see `overload.h`. Drops are summarised at most once per `dropReportInterval`.
+        static constexpr std::uint64_t dropReportInterval = 1000;
+        static inline OverloadGate blockingGate;
+        static inline std::atomic<std::uint64_t> pendingDrops{0};
+        static inline std::atomic<std::uint64_t> pendingConsoleDrops{0};
+        static inline std::atomic<std::uint64_t> lastDropReport{0};
+        static inline std::atomic<Logger*> dropReporter{nullptr};
+        OverloadGate gate;
+
+        // Compiled from the patterns given at `configure()`; see `layout.h`
+        Layout fileLayout;
+        Layout consoleLayout;
+        Layout consoleAnsiLayout;
+        bool sharedLayout = true;
+
+        static void colorize(std::string& text, const std::string& ansiCode)
         {
-            if (!this->getPrefix().empty())
-            {
-                text.insert(0, 1, ' ');
-                text.insert(0, 1, ']');
-                text.insert(0, this->getPrefix());
-                text.insert(0, 1, '[');
-            }
+            text.insert(0, ansiCode);
+            text.append(ansiReset);
         }
 
-        void colorize(std::string& text, const std::string* ansiCode = nullptr)
+        bool logToFile(const std::string& text, OverloadGate& gate, std::uint64_t& offset,
+                       const std::uint64_t firstTime, const std::uint64_t lastTime)
         {
-            if (ansiCode == nullptr)
+            offset = noFileOffset;
+            if (_channel != nullptr)
             {
-                if (!this->getAnsiCode().empty())
-                {
-                    text.insert(0, this->getAnsiCode());
-                    text.append(this->ansiReset);
-                }
+                // The collector process owns the file; a full channel drops rather than waiting
+                if (!_channel->write(this->getLogLevel(), text)) return false;
+                Stats::add(_stats.bytes[File], text.size() + 1);
+                return true;
             }
-            else
+            if (_fileLogger != nullptr)
             {
-                text.insert(0, *ansiCode);
-                text.append(this->ansiReset);
+                return _fileLogger->log(text, this->getLogLevel(), gate, offset, firstTime, lastTime);
             }
+            return true;
         }
 
-        bool shouldLog()
+        std::uint64_t logToFile(const std::string& text)
         {
-            return this->getLogLevel() >= _logLevel;
+            std::uint64_t offset;
+            const std::uint64_t time = wallClockMs();
+            logToFile(text, blockingGate, offset, time, time);
+            return offset;
         }
 
-        static void logToFile(const std::string& text)
+        static void logToStdout(const std::string& text)
         {
-            if (_fileLogger != nullptr)
+            std::cout << text << std::endl;
+            Stats::add(_stats.bytes[Stdout], text.size() + 1);
+        }
+
+        static void logToStderr(const std::string& text)
+        {
+            std::cerr << text << std::endl;
+            Stats::add(_stats.bytes[Stderr], text.size() + 1);
+        }
+
+        static bool logToConsole(const std::string& text, OverloadGate& gate = blockingGate)
+        {
+            if (_asyncConsole.load(std::memory_order_relaxed))
             {
-                _fileLogger->log(text);
+                if (!consoleWriter.write(text, gate)) return false;
+                Stats::add(_stats.bytes[Stdout], text.size() + 1);
+                Stats::add(_stats.bytes[Stderr], text.size() + 1);
+                return true;
             }
+
+            // Written by the calling thread, so lines stay in order with whatever else the app prints
+            const std::unique_lock lock = gate.enter(consoleMutex);
+            if (!lock.owns_lock()) return false;
+            logToStdout(text);
+            logToStderr(text);
+            return true;
         }
 
-        static void logToStdout(const std::string& text)
+        /**
+         * Log a "messages dropped" warning if anything was dropped since the last one, at most once per interval
+         */
+        static void reportDrops(const std::uint64_t time, const bool logToConsole, const bool force = false)
         {
-            std::cout << text << std::endl;
+            std::uint64_t last = lastDropReport.load(std::memory_order_relaxed);
+            if (!force && time < last + dropReportInterval) return;
+            // Only one thread reports per interval
+            if (!lastDropReport.compare_exchange_strong(last, time, std::memory_order_relaxed)) return;
+
+            const std::uint64_t dropped = pendingDrops.exchange(0, std::memory_order_relaxed);
+            const std::uint64_t consoleDropped = pendingConsoleDrops.exchange(0, std::memory_order_relaxed);
+            Logger* reporter = dropReporter.load(std::memory_order_acquire);
+            if ((dropped == 0 && consoleDropped == 0) || reporter == nullptr) return;
+
+            std::string text = std::to_string(dropped) + " messages dropped under load";
+            if (consoleDropped != 0)
+            {
+                text += " (and " + std::to_string(consoleDropped) + " more from the console only)";
+            }
+            // Written whatever the log level, since the drops it reports were of records that passed it. A full
+            // channel can still refuse it; the counts then wait for the next report rather than being lost.
+            if (!reporter->write(Record{Warning, text, noSite, time, currentThreadId()}, logToConsole, nullptr, true))
+            {
+                pendingDrops.fetch_add(dropped, std::memory_order_relaxed);
+                pendingConsoleDrops.fetch_add(consoleDropped, std::memory_order_relaxed);
+            }
         }
 
-        static void logToStderr(const std::string& text)
+        /**
+         * Write `record` to every sink without checking the log level
+         *
+         * @param bypassOverload    Block on busy sinks regardless of this level's overload policy. Only a full
+         *                          channel can still refuse such a record, and that isn't counted as a drop; the
+         *                          caller finds out from the result.
+         *
+         * @return Whether the file (or channel) took the record
+         */
+        bool write(const Record& record, const bool logToConsole, const std::string* ansiCode,
+                   const bool bypassOverload)
         {
-            std::cerr << text << std::endl;
+            const clock::Ticks start = clock::now();
+            const bool showSource = _sourceLocation.load(std::memory_order_relaxed);
+            const bool shortPaths = _shortSourcePaths.load(std::memory_order_relaxed);
+
+            // Each sink gets the escaped message only if it asked for it and the message needed it
+            const bool sanitizeFile = _sanitizeFile.load(std::memory_order_relaxed);
+            const bool sanitizeConsole = logToConsole && _sanitizeConsole.load(std::memory_order_relaxed);
+            std::string escaped;
+            Record safeRecord = record;
+            const bool dirty = (sanitizeFile || sanitizeConsole) && sanitize::escape(record.message, escaped);
+            if (dirty) safeRecord.message = escaped;
+            const Record& fileRecord = dirty && sanitizeFile ? safeRecord : record;
+            const Record& consoleRecord = dirty && sanitizeConsole ? safeRecord : record;
+
+            std::string line;
+            line.reserve(record.message.size() + 64);
+            fileLayout.render(fileRecord, line, showSource, shortPaths);
+            OverloadGate& overload = bypassOverload ? blockingGate : gate;
+            std::uint64_t fileOffset;
+            if (!logToFile(line, overload, fileOffset, record.time, record.time))
+            {
+                if (bypassOverload) return false;
+                Stats::add(_stats.drops);
+                pendingDrops.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (_tail != nullptr) _tail->publish(getLogLevel(), line, fileOffset, record.time);
+
+            bool consoleWritten = true;
+            if (logToConsole)
+            {
+                const bool ansi = _ansi.load(std::memory_order_relaxed);
+                if (sharedLayout && !ansi && &fileRecord == &consoleRecord)
+                {
+                    consoleWritten = Logger::logToConsole(line, overload);
+                }
+                else
+                {
+                    std::string consoleLine;
+                    consoleLine.reserve(line.size() + 16);
+                    if (ansi && ansiCode != nullptr)
+                    {
+                        consoleLayout.render(consoleRecord, consoleLine, showSource, shortPaths);
+                        colorize(consoleLine, *ansiCode);
+                    }
+                    else
+                    {
+                        (ansi ? consoleAnsiLayout : consoleLayout).render(consoleRecord, consoleLine, showSource,
+                                                                          shortPaths);
+                    }
+                    consoleWritten = Logger::logToConsole(consoleLine, overload);
+                }
+            }
+            if (!consoleWritten)
+            {
+                Stats::add(_stats.consoleDrops);
+                pendingConsoleDrops.fetch_add(1, std::memory_order_relaxed);
+            }
+            Stats::add(_stats.messages[getLogLevel()]);
+            _stats.logLatency.recordTicks(start);
+
+            if (!bypassOverload && (pendingDrops.load(std::memory_order_relaxed) != 0
+                || pendingConsoleDrops.load(std::memory_order_relaxed) != 0))
+            {
+                reportDrops(record.time, logToConsole);
+            }
+            return true;
         }
 
     protected:
@@ -94,19 +255,96 @@ namespace axologl
     public:
         virtual ~Logger() = default;
 
-        void log(std::string& text, bool logToConsole, const std::string* ansiCode = nullptr)
+        /**
+         * Whether this level is currently logged; use it to skip building expensive messages
+         */
+        bool shouldLog()
         {
-            if (shouldLog())
+            return this->getLogLevel() >= _logLevel;
+        }
+
+        void setOverloadPolicy(const OverloadPolicy& policy)
+        {
+            gate.setPolicy(policy);
+        }
+
+        /**
+         * Make `logger` the one that reports dropped messages, or `nullptr` to stop reporting them. Any drops not
+         * reported yet are reported first.
+         */
+        static void setDropReporter(Logger* logger, const bool logToConsole)
+        {
+            if (dropReporter.load(std::memory_order_acquire) != nullptr) reportDrops(wallClockMs(), logToConsole, true);
+            dropReporter.store(logger, std::memory_order_release);
+        }
+
+        /**
+         * Wait until every console line logged so far has been written out; only needed with `asyncConsole`
+         */
+        static void flushConsole()
+        {
+            consoleWriter.flush();
+        }
+
+        /**
+         * Write out console lines still queued with `asyncConsole`, from a crash handler (see `crash.h`)
+         */
+        static void emergencyFlushConsole()
+        {
+            consoleWriter.emergencyFlush();
+        }
+
+        [[nodiscard]] const Layout& getFileLayout() const
+        {
+            return fileLayout;
+        }
+
+        /**
+         * Compile this level's layouts. Console output uses `consolePattern`, wrapped in the level's colour when ANSI
+         * output is enabled.
+         */
+        void setPatterns(const std::string_view filePattern, const std::string_view consolePattern)
+        {
+            fileLayout = Layout(filePattern, getPrefix());
+            consoleLayout = Layout(consolePattern, getPrefix());
+            consoleAnsiLayout = Layout(consolePattern, getPrefix(), getAnsiCode());
+            sharedLayout = filePattern == consolePattern;
+        }
+
+        /**
+         * @param text          The message
+         * @param logToConsole  Whether to also write to stdout and stderr
+         * @param ansiCode      (Optional) Overrides the level's colour
+         * @param site          (Optional) The call site, from `intern()`
+         */
+        void log(const std::string& text, bool logToConsole, const std::string* ansiCode = nullptr,
+                 const SiteId site = noSite)
+        {
+            if (!shouldLog())
             {
-                format(text);
-                logToFile(text);
-                if (_ansi) colorize(text, ansiCode);
-                if (logToConsole)
-                {
-                    logToStdout(text);
-                    logToStderr(text);
-                }
+                Stats::add(_stats.filtered[getLogLevel()]);
+                return;
+            }
+
+            log(Record{getLogLevel(), text, site, wallClockMs(), currentThreadId()}, logToConsole, ansiCode);
+        }
+
+        /**
+         * Write a record that already has its time and thread, e.g. one replayed from before `configure()`. The
+         * record's level is ignored in favour of this logger's.
+         *
+         * @param bypassOverload    Block on busy sinks regardless of this level's overload policy (see `write()`)
+         */
+        void log(const Record& record, bool logToConsole, const std::string* ansiCode = nullptr,
+                 const bool bypassOverload = false)
+        {
+            if (!shouldLog())
+            {
+                Stats::add(_stats.filtered[getLogLevel()]);
+                return;
             }
+
+            write(record, logToConsole, ansiCode, bypassOverload);
         }
     };
 }
@@ -0,0 +1,153 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_OVERLOAD_H
+#define AXOLOGL_OVERLOAD_H
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace axologl
+{
+    /**
+     * What a logging call does when the sink it needs is busy with another thread's output
+     */
+    enum class Overload
+    {
+        Block,      // Wait for as long as it takes
+        BlockFor,   // Wait up to `OverloadPolicy::timeout`, then drop the message
+        Sample,     // Let one in `OverloadPolicy::sampleEvery` busy messages wait; drop the rest
+        Drop,       // Drop the message
+    };
+
+    /**
+     * @struct OverloadPolicy
+     *
+     * @param action        What to do when the sink is busy
+     * @param timeout       How long `Overload::BlockFor` waits
+     * @param sampleEvery   For `Overload::Sample`, one in this many busy messages is kept
+     */
+    struct OverloadPolicy
+    {
+        Overload action = Overload::Block;
+        std::chrono::milliseconds timeout{2};
+        std::uint32_t sampleEvery = 16;
+    };
+
+    /**
+     * Applies one level's `OverloadPolicy` to the sinks' locks, and to the sinks' background writers when they are
+     * still busy with earlier output. A free lock or an idle writer is always taken straight away; the policy only
+     * decides what happens when they are busy.
+     */
+    class OverloadGate
+    {
+        OverloadPolicy policy;
+        std::atomic<std::uint32_t> contended{0};
+
+    public:
+        OverloadGate() = default;
+
+        void setPolicy(const OverloadPolicy& policy)
+        {
+            this->policy = policy;
+        }
+
+        [[nodiscard]] const OverloadPolicy& getPolicy() const
+        {
+            return policy;
+        }
+
+        /**
+         * @return A lock on `mutex`, which doesn't own it if the message should be dropped
+         */
+        template <typename Mutex>
+        std::unique_lock<Mutex> enter(Mutex& mutex)
+        {
+            if (policy.action == Overload::Block)
+            {
+                return std::unique_lock(mutex);
+            }
+
+            std::unique_lock lock(mutex, std::try_to_lock);
+            if (lock.owns_lock())
+            {
+                return lock;
+            }
+
+            switch (policy.action)
+            {
+            case Overload::BlockFor:
+            {
+                // Polled rather than a timed wait so that the sinks can keep plain mutexes
+                const auto deadline = std::chrono::steady_clock::now() + policy.timeout;
+                while (!lock.try_lock() && std::chrono::steady_clock::now() < deadline)
+                {
+                    std::this_thread::yield();
+                }
+                break;
+            }
+            case Overload::Sample:
+            {
+                const std::uint32_t every = policy.sampleEvery != 0 ? policy.sampleEvery : 1;
+                if (contended.fetch_add(1, std::memory_order_relaxed) % every == 0) lock.lock();
+                break;
+            }
+            default:
+                break;
+            }
+            return lock;
+        }
+
+        /**
+         * Wait on `condition` until `ready()` holds, for as long as the policy allows
+         *
+         * @return Whether `ready()` holds; if not, the message should be dropped
+         */
+        template <typename Predicate>
+        bool wait(std::unique_lock<std::mutex>& lock, std::condition_variable& condition, Predicate ready)
+        {
+            if (ready())
+            {
+                return true;
+            }
+
+            switch (policy.action)
+            {
+            case Overload::Block:
+                condition.wait(lock, ready);
+                return true;
+            case Overload::BlockFor:
+                return condition.wait_for(lock, policy.timeout, ready);
+            case Overload::Sample:
+            {
+                const std::uint32_t every = policy.sampleEvery != 0 ? policy.sampleEvery : 1;
+                if (contended.fetch_add(1, std::memory_order_relaxed) % every != 0) return false;
+                condition.wait(lock, ready);
+                return true;
+            }
+            default:
+                return false;
+            }
+        }
+    };
+}
+
+#endif //AXOLOGL_OVERLOAD_H
@@ -0,0 +1,59 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_PLATFORM_H
+#define AXOLOGL_PLATFORM_H
+
+#ifdef __SWITCH__
+#include <switch.h>
+#else
+#include <cstdint>
+
+/*
+ * Host stand-ins for the few libnx pieces Axologl touches, so that the library can be built and tested on a PC.
+ * The console is always "initialised" (stdout is the console) and nxlink never connects.
+ */
+using Result = std::uint32_t;
+
+struct PrintConsole
+{
+    bool consoleInitialised;
+};
+
+inline PrintConsole* consoleGetDefault()
+{
+    static PrintConsole console{true};
+    return &console;
+}
+
+inline Result socketInitializeDefault()
+{
+    return 0;
+}
+
+inline void socketExit()
+{
+}
+
+inline int nxlinkConnectToHost(bool, bool)
+{
+    return -1;
+}
+#endif
+
+#endif //AXOLOGL_PLATFORM_H
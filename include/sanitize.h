@@ -0,0 +1,207 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_SANITIZE_H
+#define AXOLOGL_SANITIZE_H
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/*
+ * Makes untrusted message text safe to print. Control characters (other than tab and newline), DEL, the C1 controls
+ * and invalid UTF-8 are written out as `\xNN`, which also leaves ANSI escape sequences inert since they all start with
+ * ESC or a C1 control. Valid UTF-8 is kept.
+ *
+ * Text is scanned with SIMD for anything that isn't plain printable ASCII, so clean text is never copied;
+ * only the bytes around a suspect one are looked at individually.
+ */
+namespace axologl::sanitize
+{
+    namespace detail
+    {
+        inline bool isSuspect(const std::uint8_t byte)
+        {
+            return (byte < 0x20 && byte != '\t' && byte != '\n') || byte >= 0x7F;
+        }
+
+        inline std::size_t findSuspectScalar(const std::string_view text, std::size_t from)
+        {
+            for (; from < text.size(); from++)
+            {
+                if (isSuspect(static_cast<std::uint8_t>(text[from]))) break;
+            }
+            return from;
+        }
+
+        /**
+         * @return The index of the first byte at or after `from` that isn't printable ASCII, tab or newline, or
+         *         `text.size()` if there isn't one
+         */
+        inline std::size_t findSuspect(const std::string_view text, std::size_t from)
+        {
+#if defined(__SSE2__)
+            const auto suspects = [&text](const std::size_t at) {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + at));
+                // Signed compare: bytes from 0x80 up are negative, so count as below the space
+                const __m128i control = _mm_or_si128(_mm_cmplt_epi8(bytes, _mm_set1_epi8(0x20)),
+                                                     _mm_cmpeq_epi8(bytes, _mm_set1_epi8(0x7F)));
+                const __m128i allowed = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t')),
+                                                     _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')));
+                return _mm_andnot_si128(allowed, control);
+            };
+
+            // Clean text is the common case, so 64 bytes are checked at once and only searched when one is suspect
+            for (; from + 64 <= text.size(); from += 64)
+            {
+                const __m128i any = _mm_or_si128(_mm_or_si128(suspects(from), suspects(from + 16)),
+                                                 _mm_or_si128(suspects(from + 32), suspects(from + 48)));
+                if (_mm_movemask_epi8(any) != 0) break;
+            }
+            for (; from + 16 <= text.size(); from += 16)
+            {
+                const int mask = _mm_movemask_epi8(suspects(from));
+                if (mask != 0) return from + __builtin_ctz(static_cast<unsigned>(mask));
+            }
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+            const uint8x16_t space = vdupq_n_u8(0x20);
+            const uint8x16_t del = vdupq_n_u8(0x7F);
+            const uint8x16_t tab = vdupq_n_u8('\t');
+            const uint8x16_t newline = vdupq_n_u8('\n');
+            const auto suspects = [&](const std::size_t at) {
+                const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const std::uint8_t*>(text.data() + at));
+                const uint8x16_t control = vorrq_u8(vcltq_u8(bytes, space), vcgeq_u8(bytes, del));
+                const uint8x16_t allowed = vorrq_u8(vceqq_u8(bytes, tab), vceqq_u8(bytes, newline));
+                return vbicq_u8(control, allowed);
+            };
+
+            for (; from + 64 <= text.size(); from += 64)
+            {
+                const uint8x16_t any = vorrq_u8(vorrq_u8(suspects(from), suspects(from + 16)),
+                                                vorrq_u8(suspects(from + 32), suspects(from + 48)));
+                if (vmaxvq_u8(any) != 0) break;
+            }
+            for (; from + 16 <= text.size(); from += 16)
+            {
+                if (vmaxvq_u8(suspects(from)) != 0) return findSuspectScalar(text, from);
+            }
+#endif
+            return findSuspectScalar(text, from);
+        }
+
+        /**
+         * @return The length of the well-formed UTF-8 character starting at `i`, or 0 if it is invalid or a C1
+         *         control (U+0080 to U+009F), which terminals treat like the 7-bit ones
+         */
+        inline std::size_t characterLength(const std::string_view text, const std::size_t i)
+        {
+            const auto at = [&text, i](const std::size_t offset) {
+                return i + offset < text.size() ? static_cast<std::uint8_t>(text[i + offset]) : 0;
+            };
+            const auto continuation = [](const std::uint8_t byte) {
+                return (byte & 0xC0) == 0x80;
+            };
+
+            const std::uint8_t lead = at(0);
+            const std::uint8_t second = at(1);
+            if (lead >= 0xC2 && lead <= 0xDF)
+            {
+                return continuation(second) && !(lead == 0xC2 && second < 0xA0) ? 2 : 0;
+            }
+            if (lead >= 0xE0 && lead <= 0xEF)
+            {
+                // Rules out overlong forms and UTF-16 surrogates
+                const bool inRange = lead == 0xE0 ? second >= 0xA0 : lead == 0xED ? second < 0xA0 : true;
+                return inRange && continuation(second) && continuation(at(2)) ? 3 : 0;
+            }
+            if (lead >= 0xF0 && lead <= 0xF4)
+            {
+                const bool inRange = lead == 0xF0 ? second >= 0x90 : lead == 0xF4 ? second < 0x90 : true;
+                return inRange && continuation(second) && continuation(at(2)) && continuation(at(3)) ? 4 : 0;
+            }
+            return 0;
+        }
+
+        inline void appendEscaped(std::string& out, const std::uint8_t byte)
+        {
+            constexpr char digits[] = "0123456789abcdef";
+            const char escaped[4] = {'\\', 'x', digits[byte >> 4], digits[byte & 0xF]};
+            out.append(escaped, sizeof(escaped));
+        }
+    }
+
+    /**
+     * @return Whether `text` can be printed as it is
+     */
+    inline bool clean(const std::string_view text)
+    {
+        std::size_t i = detail::findSuspect(text, 0);
+        while (i < text.size())
+        {
+            const std::size_t length = detail::characterLength(text, i);
+            if (length == 0) return false;
+            i = detail::findSuspect(text, i + length);
+        }
+        return true;
+    }
+
+    /**
+     * Escape whatever in `text` isn't safe to print
+     *
+     * @param text  The untrusted text
+     * @param out   Set to the escaped text, but only if anything needed escaping
+     *
+     * @return Whether anything needed escaping; if not, `text` is safe as it is and `out` is untouched
+     */
+    inline bool escape(const std::string_view text, std::string& out)
+    {
+        bool escaped = false;
+        std::size_t copied = 0;
+        std::size_t i = detail::findSuspect(text, 0);
+        while (i < text.size())
+        {
+            const std::size_t length = detail::characterLength(text, i);
+            if (length != 0)
+            {
+                i = detail::findSuspect(text, i + length);
+                continue;
+            }
+
+            if (!escaped)
+            {
+                out.clear();
+                out.reserve(text.size() + 16);
+                escaped = true;
+            }
+            out.append(text, copied, i - copied);
+            detail::appendEscaped(out, static_cast<std::uint8_t>(text[i]));
+            copied = ++i;
+            i = detail::findSuspect(text, i);
+        }
+
+        if (escaped) out.append(text, copied);
+        return escaped;
+    }
+}
+
+#endif //AXOLOGL_SANITIZE_H
@@ -0,0 +1,207 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_STATS_H
+#define AXOLOGL_STATS_H
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "clock.h"
+#include "levels.h"
+
+namespace axologl
+{
+    /**
+     * A point-in-time copy of a `LatencyHistogram`
+     */
+    struct HistogramSnapshot
+    {
+        // Eight sub-buckets per power of two keeps the relative error of any reported value under 12.5%
+        static constexpr unsigned subBucketBits = 3;
+        static constexpr std::size_t bucketCount = (64 - subBucketBits + 1) << subBucketBits;
+
+        std::array<std::uint64_t, bucketCount> counts{};
+
+        static std::size_t bucketFor(const std::uint64_t value)
+        {
+            if (value < (1u << subBucketBits))
+            {
+                return value;
+            }
+            const unsigned shift = 63 - __builtin_clzll(value) - subBucketBits;
+            return (static_cast<std::size_t>(shift) << subBucketBits) + (value >> shift);
+        }
+
+        static std::uint64_t upperBound(const std::size_t bucket)
+        {
+            if (bucket < (1u << subBucketBits))
+            {
+                return bucket;
+            }
+            const unsigned shift = (bucket >> subBucketBits) - 1;
+            const std::uint64_t top = (bucket & ((1u << subBucketBits) - 1)) + (1u << subBucketBits);
+            return ((top + 1) << shift) - 1;
+        }
+
+        [[nodiscard]] std::uint64_t count() const
+        {
+            std::uint64_t total = 0;
+            for (const std::uint64_t c : counts) total += c;
+            return total;
+        }
+
+        /**
+         * @param quantile A value in [0, 1], e.g. 0.99
+         *
+         * @return An upper bound for the given quantile, in nanoseconds
+         */
+        [[nodiscard]] std::uint64_t percentile(const double quantile) const
+        {
+            const std::uint64_t total = count();
+            if (total == 0)
+            {
+                return 0;
+            }
+
+            const auto rank = static_cast<std::uint64_t>(quantile * static_cast<double>(total - 1)) + 1;
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < bucketCount; i++)
+            {
+                seen += counts[i];
+                if (seen >= rank)
+                {
+                    return upperBound(i);
+                }
+            }
+            return upperBound(bucketCount - 1);
+        }
+    };
+
+    /**
+     * HDR-style log-linear histogram of durations in nanoseconds, safe to record into from any thread
+     */
+    class LatencyHistogram
+    {
+        std::array<std::atomic<std::uint64_t>, HistogramSnapshot::bucketCount> counts{};
+
+    public:
+        void record(const std::uint64_t ns)
+        {
+            counts[HistogramSnapshot::bucketFor(ns)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void recordTicks(const clock::Ticks start)
+        {
+            record(clock::toNs(clock::now() - start));
+        }
+
+        [[nodiscard]] HistogramSnapshot snapshot() const
+        {
+            HistogramSnapshot snapshot;
+            for (std::size_t i = 0; i < counts.size(); i++)
+            {
+                snapshot.counts[i] = counts[i].load(std::memory_order_relaxed);
+            }
+            return snapshot;
+        }
+    };
+
+    /**
+     * @struct StatsSnapshot
+     *
+     * @brief A copy of the logger's self-metrics, as returned by `axologl::stats()`
+     *
+     * @param messages          Messages written, per level
+     * @param filtered          Messages discarded by the log level, per level
+     * @param bytes             Bytes handed to each sink
+     * @param drops             Messages dropped rather than written, by an overload policy or a full buffer
+     * @param consoleDrops      Messages written to the file but dropped from the console by an overload policy
+     * @param blockWrites       Blocks of buffered output written to the log file by its writer thread
+     * @param syncs             `fsync` calls made for `AxologlOptions::durability`
+     * @param logLatency        Time spent in `Logger::log` for messages that were written
+     * @param fileWriteLatency  Time spent in `FileLogger::write`
+     */
+    struct StatsSnapshot
+    {
+        std::array<std::uint64_t, levelCount> messages{};
+        std::array<std::uint64_t, levelCount> filtered{};
+        std::array<std::uint64_t, sinkCount> bytes{};
+        std::uint64_t drops = 0;
+        std::uint64_t consoleDrops = 0;
+        std::uint64_t blockWrites = 0;
+        std::uint64_t syncs = 0;
+        HistogramSnapshot logLatency;
+        HistogramSnapshot fileWriteLatency;
+    };
+
+    /**
+     * Always-on counters behind `axologl::stats()`. Everything is a relaxed atomic so that recording never orders or
+     * blocks the logging threads.
+     */
+    struct Stats
+    {
+        std::array<std::atomic<std::uint64_t>, levelCount> messages{};
+        std::array<std::atomic<std::uint64_t>, levelCount> filtered{};
+        std::array<std::atomic<std::uint64_t>, sinkCount> bytes{};
+        std::atomic<std::uint64_t> drops{0};
+        std::atomic<std::uint64_t> consoleDrops{0};
+        std::atomic<std::uint64_t> blockWrites{0};
+        std::atomic<std::uint64_t> syncs{0};
+        LatencyHistogram logLatency;
+        LatencyHistogram fileWriteLatency;
+
+        static void add(std::atomic<std::uint64_t>& counter, const std::uint64_t amount = 1)
+        {
+            counter.fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] StatsSnapshot snapshot() const
+        {
+            StatsSnapshot snapshot;
+            for (std::size_t i = 0; i < levelCount; i++)
+            {
+                snapshot.messages[i] = messages[i].load(std::memory_order_relaxed);
+                snapshot.filtered[i] = filtered[i].load(std::memory_order_relaxed);
+            }
+            for (std::size_t i = 0; i < sinkCount; i++)
+            {
+                snapshot.bytes[i] = bytes[i].load(std::memory_order_relaxed);
+            }
+            snapshot.drops = drops.load(std::memory_order_relaxed);
+            snapshot.consoleDrops = consoleDrops.load(std::memory_order_relaxed);
+            snapshot.blockWrites = blockWrites.load(std::memory_order_relaxed);
+            snapshot.syncs = syncs.load(std::memory_order_relaxed);
+            snapshot.logLatency = logLatency.snapshot();
+            snapshot.fileWriteLatency = fileWriteLatency.snapshot();
+            return snapshot;
+        }
+    };
+
+    inline Stats _stats;
+
+    /**
+     * @return A snapshot of the logger's self-metrics
+     */
+    inline StatsSnapshot stats()
+    {
+        return _stats.snapshot();
+    }
+}
+
+#endif //AXOLOGL_STATS_H
@@ -0,0 +1,395 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_TAIL_H
+#define AXOLOGL_TAIL_H
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if !defined(__SWITCH__) && __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define AXOLOGL_TAIL_MMAP 1
+#endif
+
+#include "levels.h"
+
+namespace axologl
+{
+    // Marks a record with no position in the log file (no file logger, or a compressed log)
+    inline constexpr std::uint64_t noFileOffset = UINT64_MAX;
+
+    /**
+     * @struct TailRecord
+     *
+     * @brief A log record as seen by a `LogTail` reader
+     *
+     * @param seq           Sequence number, starting at 1; 0 for records paged in from the log file
+     * @param level         The level the record was logged at
+     * @param time          Wall-clock time in milliseconds since the Unix epoch; 0 for records paged in from the file
+     * @param fileOffset    Where the record starts in the log file, or `noFileOffset`
+     * @param truncated     Whether `text` was cut to fit the in-memory slot
+     * @param text          The record as written to the log file, without a trailing newline
+     */
+    struct TailRecord
+    {
+        std::uint64_t seq = 0;
+        LogLevel level = Raw;
+        std::uint64_t time = 0;
+        std::uint64_t fileOffset = noFileOffset;
+        bool truncated = false;
+        std::string text;
+    };
+
+    /**
+     * A reader's position in the stream of records
+     */
+    struct TailCursor
+    {
+        std::uint64_t next = 1;
+    };
+
+    /**
+     * Reads the plain-text log file backwards, a record at a time. The file is memory-mapped where the platform
+     * supports it and read into a buffer otherwise.
+     */
+    class FileHistory
+    {
+        std::filesystem::path path;
+        LevelLocator levels;
+
+        static constexpr std::size_t chunkSize = 16 * 1024;
+
+        static bool isLineStart(const std::string_view window, const std::size_t i, const bool atFileStart)
+        {
+            return i == 0 ? atFileStart : window[i - 1] == '\n';
+        }
+
+        std::size_t countRecords(const std::string_view window, const bool atFileStart) const
+        {
+            std::size_t records = 0;
+            LogLevel level;
+            for (std::size_t i = 0; i < window.size(); i++)
+            {
+                if (isLineStart(window, i, atFileStart) && levels.find(window.substr(i), level)) records++;
+            }
+            return records;
+        }
+
+        bool readRange(const std::uint64_t begin, const std::uint64_t end, std::string& out) const
+        {
+            out.resize(end - begin);
+            FILE* file = fopen(path.c_str(), "rb");
+            if (file == nullptr) return false;
+            const bool ok = fseek(file, static_cast<long>(begin), SEEK_SET) == 0
+                && fread(out.data(), 1, out.size(), file) == out.size();
+            fclose(file);
+            return ok;
+        }
+
+    public:
+        /**
+         * @param path      The log file
+         * @param pattern   The file pattern its records are laid out with
+         */
+        explicit FileHistory(std::filesystem::path path, const std::string_view pattern = defaultPattern)
+            : path(std::move(path)), levels(pattern)
+        {
+        }
+
+        /**
+         * Collect up to `count` records that end before `offset`, newest first
+         */
+        void before(std::uint64_t offset, const std::size_t count, std::vector<TailRecord>& out) const
+        {
+            std::error_code error;
+            if (path.empty() || offset == noFileOffset || count == 0) return;
+            offset = std::min<std::uint64_t>(offset, std::filesystem::file_size(path, error));
+            if (error || offset == 0) return;
+
+#ifdef AXOLOGL_TAIL_MMAP
+            const int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) return;
+            void* mapped = mmap(nullptr, offset, PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);
+            if (mapped == MAP_FAILED) return;
+            const auto* base = static_cast<const char*>(mapped);
+#else
+            std::string buffer;
+#endif
+
+            // Widen the window backwards until it holds enough record starts
+            std::string_view window;
+            std::uint64_t begin = offset;
+            do
+            {
+                begin -= std::min<std::uint64_t>(std::max<std::uint64_t>(chunkSize, offset - begin), begin);
+#ifdef AXOLOGL_TAIL_MMAP
+                window = std::string_view(base + begin, offset - begin);
+#else
+                if (!readRange(begin, offset, buffer)) return;
+                window = buffer;
+#endif
+            } while (begin > 0 && countRecords(window, false) < count);
+
+            // Split into records, newest first; lines without a prefix belong to the record above them
+            const bool atFileStart = begin == 0;
+            std::size_t recordEnd = window.size();
+            if (recordEnd > 0 && window[recordEnd - 1] == '\n') recordEnd--;
+            for (std::size_t i = recordEnd; i-- > 0 && out.size() < count;)
+            {
+                TailRecord record;
+                if (!isLineStart(window, i, atFileStart)
+                    || !levels.find(window.substr(i, recordEnd - i), record.level))
+                {
+                    continue;
+                }
+                record.fileOffset = begin + i;
+                record.text.assign(window.substr(i, recordEnd - i));
+                out.push_back(std::move(record));
+                recordEnd = i > 0 ? i - 1 : 0;
+            }
+
+#ifdef AXOLOGL_TAIL_MMAP
+            munmap(mapped, offset);
+#endif
+        }
+    };
+
+    /**
+     * Keeps the most recent records in memory for in-app log viewers. Writers never wait: each slot is a seqlock, and
+     * a writer that finds its slot busy simply leaves the record out of the tail (the file still has it). Readers
+     * detect records that were overwritten while they copied them.
+     */
+    class LogTail
+    {
+        static constexpr std::size_t slotWords = 32;
+
+    public:
+        // Records longer than this are truncated in memory
+        static constexpr std::size_t slotTextSize = slotWords * sizeof(std::uint64_t);
+
+    private:
+        struct Slot
+        {
+            // Odd while being written; 2 * seq once record `seq` is complete
+            std::atomic<std::uint64_t> version{0};
+            std::atomic<std::uint64_t> time{0};
+            std::atomic<std::uint64_t> fileOffset{0};
+            std::atomic<std::uint32_t> meta{0};
+            std::array<std::atomic<std::uint64_t>, slotWords> words{};
+        };
+
+        std::unique_ptr<Slot[]> slots;
+        std::size_t mask;
+        std::atomic<std::uint64_t> head{0};
+        FileHistory history;
+        std::uint64_t (*historyEnd)() = nullptr;
+
+        bool read(const std::uint64_t seq, TailRecord& record) const
+        {
+            const Slot& slot = slots[seq & mask];
+            const std::uint64_t expected = 2 * seq;
+            if (slot.version.load(std::memory_order_acquire) != expected)
+            {
+                return false;
+            }
+
+            const std::uint32_t meta = slot.meta.load(std::memory_order_acquire);
+            const std::size_t length = (meta >> 8) & 0xFFFF;
+            std::array<std::uint64_t, slotWords> words;
+            for (std::size_t i = 0; i < (length + 7) / 8; i++)
+            {
+                words[i] = slot.words[i].load(std::memory_order_acquire);
+            }
+            record.seq = seq;
+            record.level = static_cast<LogLevel>(meta & 0xFF);
+            record.truncated = (meta >> 31) != 0;
+            record.time = slot.time.load(std::memory_order_acquire);
+            record.fileOffset = slot.fileOffset.load(std::memory_order_acquire);
+
+            if (slot.version.load(std::memory_order_relaxed) != expected)
+            {
+                return false;
+            }
+            record.text.assign(reinterpret_cast<const char*>(words.data()), length);
+            return true;
+        }
+
+    public:
+        /**
+         * @param capacity      Number of records kept in memory, rounded up to a power of two
+         * @param historyPath   The plain-text log file to page older records from; empty if there is none
+         * @param historyEnd    (Optional) How much of the log file is on disk; records past it are still buffered by
+         *                      the file's writer and aren't paged
+         * @param historyPattern  (Optional) The file pattern the log was written with
+         */
+        explicit LogTail(std::size_t capacity, std::filesystem::path historyPath = {},
+                         std::uint64_t (*historyEnd)() = nullptr,
+                         const std::string_view historyPattern = defaultPattern)
+            : history(std::move(historyPath), historyPattern), historyEnd(historyEnd)
+        {
+            std::size_t size = 1;
+            while (size < capacity) size <<= 1;
+            slots = std::make_unique<Slot[]>(size);
+            mask = size - 1;
+        }
+
+        /**
+         * Record a message. Called by the loggers after the file write so that `fileOffset` is known.
+         *
+         * @param time  When it was logged, in milliseconds since the Unix epoch; 0 means now
+         */
+        void publish(const LogLevel level, const std::string& text, const std::uint64_t fileOffset,
+                     const std::uint64_t time = 0)
+        {
+            const std::uint64_t seq = head.fetch_add(1, std::memory_order_relaxed) + 1;
+            Slot& slot = slots[seq & mask];
+
+            // Claim the slot unless another writer holds it or it already has a newer record
+            std::uint64_t current = slot.version.load(std::memory_order_relaxed);
+            do
+            {
+                if ((current & 1) != 0 || current >= 2 * seq) return;
+            } while (!slot.version.compare_exchange_weak(current, 2 * seq - 1, std::memory_order_acquire,
+                                                         std::memory_order_relaxed));
+
+            const std::size_t length = std::min(text.size(), slotTextSize);
+            std::array<std::uint64_t, slotWords> words{};
+            std::memcpy(words.data(), text.data(), length);
+            for (std::size_t i = 0; i < (length + 7) / 8; i++)
+            {
+                // Release so that a reader seeing this data also sees the slot as claimed
+                slot.words[i].store(words[i], std::memory_order_release);
+            }
+            slot.meta.store(static_cast<std::uint32_t>(level) | static_cast<std::uint32_t>(length) << 8
+                            | (text.size() > slotTextSize ? 1u << 31 : 0u), std::memory_order_release);
+            slot.time.store(time != 0 ? time : std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count(), std::memory_order_release);
+            slot.fileOffset.store(fileOffset, std::memory_order_release);
+            slot.version.store(2 * seq, std::memory_order_release);
+        }
+
+        /**
+         * @return A cursor that will only see records published from now on
+         */
+        [[nodiscard]] TailCursor subscribe() const
+        {
+            return TailCursor{head.load(std::memory_order_acquire) + 1};
+        }
+
+        /**
+         * Copy the records published since `cursor` into `out` and advance it
+         *
+         * @param cursor    The reader's position
+         * @param out       Receives the new records, oldest first
+         * @param max       Maximum number of records to return
+         *
+         * @return The number of records that were missed because they were overwritten before being read
+         */
+        std::uint64_t poll(TailCursor& cursor, std::vector<TailRecord>& out, const std::size_t max = SIZE_MAX)
+        {
+            const std::uint64_t last = head.load(std::memory_order_acquire);
+            const std::uint64_t capacity = mask + 1;
+            std::uint64_t missed = 0;
+
+            if (last >= capacity && cursor.next <= last - capacity)
+            {
+                missed = last - capacity + 1 - cursor.next;
+                cursor.next = last - capacity + 1;
+            }
+
+            for (std::size_t taken = 0; cursor.next <= last && taken < max; cursor.next++)
+            {
+                TailRecord record;
+                if (read(cursor.next, record))
+                {
+                    out.push_back(std::move(record));
+                    taken++;
+                }
+                else if (slots[cursor.next & mask].version.load(std::memory_order_acquire) < 2 * cursor.next)
+                {
+                    // Still being written; pick it up on the next poll
+                    break;
+                }
+                else
+                {
+                    missed++;
+                }
+            }
+            return missed;
+        }
+
+        /**
+         * Page backwards through history: collect up to `count` records older than `oldest`, newest first. Records
+         * still in memory come from there; older ones are read back from the log file, as far as it is on disk. Paging
+         * never waits for the file's writer, so records that fell out of memory but are still in its buffer are
+         * skipped.
+         *
+         * @param oldest    The oldest record the reader already has; a default record starts from the newest
+         * @param count     Maximum number of records to return
+         * @param out       Receives the records
+         *
+         * @return How many bytes of the log were skipped because they are still buffered, between the records from
+         *         memory and those from the file; 0 if none were
+         */
+        std::uint64_t before(const TailRecord& oldest, const std::size_t count, std::vector<TailRecord>& out) const
+        {
+            const std::uint64_t last = head.load(std::memory_order_acquire);
+            std::uint64_t seq = oldest.seq != 0 ? oldest.seq - 1 : (oldest.fileOffset == noFileOffset ? last : 0);
+            std::uint64_t fileOffset = oldest.fileOffset;
+
+            for (; seq > 0 && out.size() < count; seq--)
+            {
+                TailRecord record;
+                if (!read(seq, record)) break;
+                fileOffset = record.fileOffset;
+                out.push_back(std::move(record));
+            }
+
+            std::uint64_t gap = 0;
+            if (out.size() < count)
+            {
+                // Records that fell out of memory may not have left the writer's buffer yet
+                const std::uint64_t end = historyEnd != nullptr ? historyEnd() : noFileOffset;
+                if (fileOffset != noFileOffset && fileOffset > end)
+                {
+                    gap = fileOffset - end;
+                    fileOffset = end;
+                }
+                std::vector<TailRecord> older;
+                history.before(fileOffset, count - out.size(), older);
+                for (auto& record : older) out.push_back(std::move(record));
+            }
+            return gap;
+        }
+    };
+}
+
+#endif //AXOLOGL_TAIL_H
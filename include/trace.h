@@ -0,0 +1,352 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef AXOLOGL_TRACE_H
+#define AXOLOGL_TRACE_H
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "axologl.h"
+#include "clock.h"
+
+namespace axologl::trace
+{
+    // Number of scopes kept per thread; older ones are overwritten
+    static constexpr std::size_t eventsPerThread = 16 * 1024;
+    // Number of scopes kept in total from threads that have exited; the oldest threads' are dropped first
+    static constexpr std::size_t retiredEvents = 16 * 1024;
+
+    struct Event
+    {
+        const char* name;
+        clock::Ticks begin;
+        clock::Ticks end;
+    };
+
+    /**
+     * A single-writer ring of completed scopes, owned by one thread at a time
+     */
+    class ThreadBuffer
+    {
+        std::array<Event, eventsPerThread> events{};
+        std::atomic<std::uint64_t> written{0};
+        std::uint32_t threadId;
+
+    public:
+        explicit ThreadBuffer(const std::uint32_t threadId) : threadId(threadId)
+        {
+        }
+
+        /**
+         * Empty the buffer and hand it to another thread
+         */
+        void reset(const std::uint32_t id)
+        {
+            threadId = id;
+            written.store(0, std::memory_order_release);
+        }
+
+        void record(const char* name, const clock::Ticks begin, const clock::Ticks end)
+        {
+            const std::uint64_t index = written.load(std::memory_order_relaxed);
+            events[index % eventsPerThread] = {name, begin, end};
+            written.store(index + 1, std::memory_order_release);
+        }
+
+        [[nodiscard]] std::uint32_t getThreadId() const
+        {
+            return threadId;
+        }
+
+        /**
+         * Visit the retained events, oldest first
+         */
+        template <typename Visitor>
+        void forEach(Visitor&& visit) const
+        {
+            const std::uint64_t count = written.load(std::memory_order_acquire);
+            const std::uint64_t first = count > eventsPerThread ? count - eventsPerThread : 0;
+            for (std::uint64_t i = first; i < count; i++)
+            {
+                visit(events[i % eventsPerThread]);
+            }
+        }
+    };
+
+    /**
+     * @struct RetiredThread
+     *
+     * @brief The scopes of a thread that has exited, kept for export after its buffer went to another thread
+     */
+    struct RetiredThread
+    {
+        std::uint32_t threadId;
+        std::vector<Event> events;
+    };
+
+    inline std::mutex _registryMutex;
+    inline std::vector<std::shared_ptr<ThreadBuffer>> _threadBuffers;
+    inline std::vector<std::shared_ptr<ThreadBuffer>> _freeBuffers;
+    inline std::deque<RetiredThread> _retiredThreads;
+    inline std::size_t _retiredEventCount = 0;
+    inline std::uint32_t _nextThreadId = 1;
+    inline std::atomic<std::uint64_t> _logThreshold{0};
+
+    /**
+     * Holds the calling thread's buffer, and on thread exit keeps its scopes and frees it for the next thread
+     */
+    class BufferLease
+    {
+        std::shared_ptr<ThreadBuffer> buffer;
+
+    public:
+        BufferLease()
+        {
+            std::lock_guard lock(_registryMutex);
+            if (_freeBuffers.empty())
+            {
+                buffer = std::make_shared<ThreadBuffer>(_nextThreadId++);
+            }
+            else
+            {
+                buffer = std::move(_freeBuffers.back());
+                _freeBuffers.pop_back();
+                buffer->reset(_nextThreadId++);
+            }
+            _threadBuffers.push_back(buffer);
+        }
+
+        BufferLease(const BufferLease&) = delete;
+        BufferLease& operator=(const BufferLease&) = delete;
+
+        ~BufferLease()
+        {
+            // Copied out before taking the lock; only the retained scopes, not the whole ring
+            RetiredThread retired{buffer->getThreadId(), {}};
+            buffer->forEach([&retired](const Event& event) { retired.events.push_back(event); });
+
+            std::lock_guard lock(_registryMutex);
+            if (!retired.events.empty())
+            {
+                _retiredEventCount += retired.events.size();
+                _retiredThreads.push_back(std::move(retired));
+                while (_retiredEventCount > retiredEvents && _retiredThreads.size() > 1)
+                {
+                    _retiredEventCount -= _retiredThreads.front().events.size();
+                    _retiredThreads.pop_front();
+                }
+            }
+            for (auto it = _threadBuffers.begin(); it != _threadBuffers.end(); ++it)
+            {
+                if (*it == buffer)
+                {
+                    _threadBuffers.erase(it);
+                    break;
+                }
+            }
+            _freeBuffers.push_back(std::move(buffer));
+        }
+
+        [[nodiscard]] ThreadBuffer& get() const
+        {
+            return *buffer;
+        }
+    };
+
+    /**
+     * @return The calling thread's buffer, taken from the free list or created on first use
+     */
+    inline ThreadBuffer& threadBuffer()
+    {
+        thread_local BufferLease lease;
+        return lease.get();
+    }
+
+    /**
+     * Log the duration of any timed scope that takes longer than `threshold`. Zero disables logging.
+     */
+    inline void setLogThreshold(const std::chrono::nanoseconds threshold)
+    {
+        _logThreshold.store(clock::fromNs(threshold.count()), std::memory_order_relaxed);
+    }
+
+    inline void writeJsonString(FILE* out, const char* text)
+    {
+        fputc('"', out);
+        for (const char* c = text; *c != '\0'; c++)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                fputc('\\', out);
+                fputc(*c, out);
+            }
+            else if (static_cast<unsigned char>(*c) < 0x20)
+            {
+                fprintf(out, "\\u%04x", *c);
+            }
+            else
+            {
+                fputc(*c, out);
+            }
+        }
+        fputc('"', out);
+    }
+
+    /**
+     * Write every retained scope as a Chrome trace-event file, which can be opened in Perfetto or `chrome://tracing`.
+     * Scopes still being recorded while this runs may be missing or torn, so call it while instrumented threads are
+     * idle (e.g. at shutdown).
+     *
+     * @param path Where to write the JSON file
+     *
+     * @return Whether the file could be written
+     */
+    inline bool exportChromeTrace(const fs::path& path)
+    {
+        FILE* out = fopen(path.c_str(), "w");
+        if (out == nullptr)
+        {
+            return false;
+        }
+
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        std::deque<RetiredThread> retired;
+        {
+            std::lock_guard lock(_registryMutex);
+            buffers = _threadBuffers;
+            retired = _retiredThreads;
+        }
+
+        // Timestamps are made relative to the earliest scope to keep them readable
+        clock::Ticks origin = ~clock::Ticks{0};
+        const auto findOrigin = [&origin](const Event& event) {
+            if (event.begin < origin) origin = event.begin;
+        };
+        for (const auto& thread : retired)
+        {
+            for (const Event& event : thread.events) findOrigin(event);
+        }
+        for (const auto& buffer : buffers)
+        {
+            buffer->forEach(findOrigin);
+        }
+
+        fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", out);
+        bool first = true;
+        const auto writeThread = [&](const std::uint32_t threadId) {
+            fprintf(out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%" PRIu32
+                    ",\"args\":{\"name\":\"thread %" PRIu32 "\"}}",
+                    first ? "" : ",", threadId, threadId);
+            first = false;
+        };
+        const auto writeEvent = [&](const std::uint32_t threadId, const Event& event) {
+            const std::uint64_t start = clock::toNs(event.begin - origin);
+            const std::uint64_t duration = clock::toNs(event.end - event.begin);
+            fputs(",\n{\"name\":", out);
+            writeJsonString(out, event.name);
+            fprintf(out, ",\"ph\":\"X\",\"pid\":1,\"tid\":%" PRIu32 ",\"ts\":%" PRIu64 ".%03" PRIu64
+                    ",\"dur\":%" PRIu64 ".%03" PRIu64 "}",
+                    threadId, start / 1000, start % 1000, duration / 1000, duration % 1000);
+        };
+
+        for (const auto& thread : retired)
+        {
+            writeThread(thread.threadId);
+            for (const Event& event : thread.events) writeEvent(thread.threadId, event);
+        }
+        for (const auto& buffer : buffers)
+        {
+            const std::uint32_t threadId = buffer->getThreadId();
+            writeThread(threadId);
+            buffer->forEach([&](const Event& event) { writeEvent(threadId, event); });
+        }
+        fputs("\n]}\n", out);
+
+        return fclose(out) == 0;
+    }
+}
+
+namespace axologl
+{
+    /**
+     * Times the enclosing scope and records it into the calling thread's trace buffer. Costs two reads of the system
+     * counter and a store; nothing is formatted unless the scope exceeds the log threshold.
+     */
+    class ScopedTimer
+    {
+        const char* name;
+        clock::Ticks threshold;
+        clock::Ticks begin;
+
+    public:
+        /**
+         * @param name      Name of the scope; must outlive the program (e.g. a string literal)
+         * @param threshold Log the duration at Debug level when it exceeds this
+         */
+        ScopedTimer(const char* name, const std::chrono::nanoseconds threshold)
+            : name(name), threshold(clock::fromNs(threshold.count())), begin(clock::now())
+        {
+        }
+
+        /**
+         * @param name Name of the scope; must outlive the program (e.g. a string literal)
+         */
+        explicit ScopedTimer(const char* name)
+            : name(name), threshold(trace::_logThreshold.load(std::memory_order_relaxed)), begin(clock::now())
+        {
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        ~ScopedTimer()
+        {
+            const clock::Ticks end = clock::now();
+            trace::threadBuffer().record(name, begin, end);
+
+            if (threshold != 0 && end - begin > threshold && _axologl.load(std::memory_order_relaxed) != nullptr)
+            {
+                const std::uint64_t ns = clock::toNs(end - begin);
+                char duration[32];
+                snprintf(duration, sizeof(duration), "%" PRIu64 ".%03" PRIu64 " ms", ns / 1000000,
+                         (ns / 1000) % 1000);
+                debug(std::string(name) + " took " + duration);
+            }
+        }
+    };
+}
+
+#define AXOLOGL_TRACE_CONCAT_INNER(a, b) a##b
+#define AXOLOGL_TRACE_CONCAT(a, b) AXOLOGL_TRACE_CONCAT_INNER(a, b)
+
+#ifdef AXOLOGL_DISABLE_TRACE
+#define AXOLOGL_TRACE_SCOPE(name) static_cast<void>(0)
+#else
+/**
+ * Time the rest of the enclosing scope under `name`, which must be a string literal
+ */
+#define AXOLOGL_TRACE_SCOPE(name) const axologl::ScopedTimer AXOLOGL_TRACE_CONCAT(_axologlTrace, __LINE__)(name)
+#endif
+
+#endif //AXOLOGL_TRACE_H
@@ -19,23 +19,22 @@
 #ifndef AXOLOGL_TYPES_H
 #define AXOLOGL_TYPES_H
 
+#include <array>
+#include <chrono>
 #include <string>
 
-#include <switch.h>
+#include "layout.h"
+#include "levels.h"
+#include "overload.h"
+#include "platform.h"
 
 namespace axologl
 {
-    enum LogLevel
-    {
-        Debug,
-        Info,
-        Notice,
-        Warning,
-        Error,
-        Fatal,
-        Raw
-    };
+    class SharedChannel;
+}
 
+namespace axologl
+{
     /**
      * @struct NxLinkOptions
      *
@@ -52,6 +51,16 @@ namespace axologl
         mutable bool redirectStderr = false;
     };
 
+    /**
+     * How hard the file logger tries to get records onto storage before a crash or power loss
+     */
+    enum class Durability
+    {
+        None,       // Write out when the buffer fills; the OS decides when it reaches storage
+        OnError,    // Error and Fatal records are flushed and synced before `error()`/`fatal()` return
+        Periodic,   // A background thread flushes and syncs every `syncInterval`
+    };
+
     struct FileLoggerOptions
     {
         bool enable = false;
@@ -68,6 +77,25 @@ namespace axologl
      * @param nxLinkOpts    A collection of options to configure nxlink
      * @param ansiOutput    Whether ANSI colours should be used
      * @param logPath       Where Axologl should write logs to
+     * @param console       The console to check before printing (defaults to libnx's default console)
+     * @param compressLog   Whether the log file should be written block-compressed
+     * @param indexLog      Whether to maintain a sidecar index (`<logPath>.idx`) for fast filtered reads
+     * @param tailRecords   How many recent records to keep in memory for `axologl::tail()` (0 disables it)
+     * @param channel       Send file output to a collector process through this shared-memory channel instead of
+     *                      opening a log file
+     * @param durability    When the log file is flushed and synced (see `Durability`)
+     * @param syncInterval  How often to sync with `Durability::Periodic`
+     * @param sourceLocation    Whether records logged through the `AXOLOGL_<LEVEL>` macros show their call site
+     * @param shortSourcePaths  Whether call sites show just the file's name rather than its full path
+     * @param filePattern       Layout of each line in the log file (see `Layout` for the fields)
+     * @param consolePattern    Layout of each line on stdout and stderr
+     * @param overload          Per level, what a logging call does when the file or console is busy with another
+     *                          thread's output; Error and Fatal always block
+     * @param sanitizeConsole   Whether messages are escaped before reaching stdout and stderr (see `sanitize.h`); off
+     *                          by default so console output stays byte for byte as before
+     * @param sanitizeFile      Whether messages are escaped before reaching the log file
+     * @param asyncConsole      Whether console lines are written from a background thread (see `console.h`) rather
+     *                          than by the logging thread; leave it off if the app also prints to the console itself
      */
     struct AxologlOptions
     {
@@ -76,6 +104,20 @@ namespace axologl
         mutable bool ansiOutput = true;
         mutable std::string logPath;
         mutable PrintConsole* console = nullptr;
+        mutable bool compressLog = false;
+        mutable bool indexLog = false;
+        mutable std::size_t tailRecords = 0;
+        mutable SharedChannel* channel = nullptr;
+        mutable Durability durability = Durability::None;
+        mutable std::chrono::milliseconds syncInterval{1000};
+        mutable bool sourceLocation = true;
+        mutable bool shortSourcePaths = true;
+        mutable std::string filePattern = std::string(defaultPattern);
+        mutable std::string consolePattern = std::string(defaultPattern);
+        mutable std::array<OverloadPolicy, levelCount> overload{};
+        mutable bool sanitizeConsole = false;
+        mutable bool sanitizeFile = false;
+        mutable bool asyncConsole = false;
     };
 }
 
@@ -19,13 +19,16 @@
 #include <switch.h>
 
 #include "axologl.h"
+#include "trace.h"
 
 void testOutput(const std::string& text)
 {
+    AXOLOGL_TRACE_SCOPE("testOutput");
     axologl::debug(text + ": Testing debug output");
     axologl::info(text + ": Testing info output");
     axologl::notice(text + ": Testing notice output");
     axologl::warn(text + ": Testing warning output");
+    AXOLOGL_WARN(text + ": Testing warning output with its call site");
     axologl::error(text + ": Testing error output");
     axologl::fatal(text + ": Testing fatal output");
     axologl::success(text + ": Testing success output");
@@ -98,6 +101,7 @@ int main(int argc, char** argv)
         consoleUpdate(nullptr);
     }
 
+    axologl::trace::exportChromeTrace("axologl/trace.json");
     axologl::teardown();
     consoleExit(nullptr);
 
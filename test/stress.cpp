@@ -0,0 +1,543 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Headless multi-threaded stress test for the host build. Worker threads log through the public API while another
+// thread keeps changing the log level, ANSI output and nxlink, and a third follows the in-memory tail. After a phase
+// for each thread count, the largest count runs twice more: once adding records through `Batch`, and once logging
+// into a `SharedChannel` that a collector thread merges back into the same file. Afterwards the log file is read back
+// and every record is checked: intact, not interleaved with another, in order per thread, and either present,
+// filtered or counted as dropped, agreeing with `axologl::stats()`.
+//
+// Usage: axologl-stress [--log path] [--threads 1,2,4,8] [--records n] [--sizes 16,100,1000]
+//                       [--mix debug:1,info:4,notice:1,warn:2,error:1,fatal:1] [--durability none|on-error|periodic]
+//                       [--overload block|drop|sample|block-for] [--no-reconfigure] [--console]
+//                       [--async-console]
+//
+// Exits non-zero if any check fails. Build with -DAXOLOGL_SANITIZE=thread or =address to run it under a sanitizer.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "axologl.h"
+#include "batch.h"
+
+namespace
+{
+    struct Settings
+    {
+        std::string logPath = "axologl-stress.log";
+        std::vector<std::size_t> threads = {1, 2, 4, 8};
+        std::size_t records = 5000;
+        std::vector<std::size_t> sizes = {16, 100, 1000};
+        std::vector<axologl::LogLevel> mix;
+        axologl::Durability durability = axologl::Durability::None;
+        // Applied to Debug, Info and Notice; Warning waits at most a millisecond unless this is Block
+        axologl::Overload overload = axologl::Overload::Block;
+        bool reconfigure = true;
+        bool console = false;
+        bool asyncConsole = false;
+    };
+
+    constexpr axologl::LogLevel mixLevels[] = {
+        axologl::Debug, axologl::Info, axologl::Notice, axologl::Warning, axologl::Error, axologl::Fatal,
+    };
+    constexpr const char* mixNames[] = {"debug", "info", "notice", "warn", "error", "fatal"};
+
+    std::vector<std::size_t> parseList(const char* text)
+    {
+        std::vector<std::size_t> values;
+        for (const char* p = text; *p != '\0';)
+        {
+            char* end;
+            values.push_back(std::strtoul(p, &end, 10));
+            p = *end == ',' ? end + 1 : end;
+            if (end == p && *p != '\0') break;
+        }
+        return values;
+    }
+
+    bool parseMix(const std::string& text, std::vector<axologl::LogLevel>& mix)
+    {
+        mix.clear();
+        std::size_t start = 0;
+        while (start < text.size())
+        {
+            std::size_t end = text.find(',', start);
+            if (end == std::string::npos) end = text.size();
+            const std::string item = text.substr(start, end - start);
+            const std::size_t colon = item.find(':');
+            const std::string name = item.substr(0, colon);
+            const std::size_t weight =
+                colon == std::string::npos ? 1 : std::strtoul(item.c_str() + colon + 1, nullptr, 10);
+
+            bool known = false;
+            for (std::size_t i = 0; i < std::size(mixNames); i++)
+            {
+                if (name == mixNames[i])
+                {
+                    mix.insert(mix.end(), weight, mixLevels[i]);
+                    known = true;
+                }
+            }
+            if (!known) return false;
+            start = end + 1;
+        }
+        return !mix.empty();
+    }
+
+    std::uint64_t mixHash(std::uint64_t x)
+    {
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCDull;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // Everything about a record follows from (thread, sequence), so the checker can regenerate it
+    axologl::LogLevel levelFor(const Settings& settings, const std::size_t thread, const std::uint64_t sequence)
+    {
+        return settings.mix[mixHash(thread * 0x9E3779B97F4A7C15ull + sequence) % settings.mix.size()];
+    }
+
+    std::size_t sizeFor(const Settings& settings, const std::size_t thread, const std::uint64_t sequence)
+    {
+        return settings.sizes[(thread + sequence) % settings.sizes.size()];
+    }
+
+    char payloadChar(const std::size_t thread, const std::uint64_t sequence, const std::size_t i)
+    {
+        return static_cast<char>('a' + (thread * 7 + sequence * 13 + i) % 26);
+    }
+
+    std::string makeRecord(const Settings& settings, const std::size_t thread, const std::uint64_t sequence)
+    {
+        std::string text = "t" + std::to_string(thread) + " n" + std::to_string(sequence) + " ";
+        const std::size_t size = sizeFor(settings, thread, sequence);
+        for (std::size_t i = 0; i < size; i++)
+        {
+            text.push_back(payloadChar(thread, sequence, i));
+        }
+        return text;
+    }
+
+    void logAt(const axologl::LogLevel level, const std::string& text)
+    {
+        switch (level)
+        {
+        case axologl::Debug: axologl::debug(text); break;
+        case axologl::Info: axologl::info(text); break;
+        case axologl::Notice: axologl::notice(text); break;
+        case axologl::Warning: axologl::warn(text); break;
+        case axologl::Error: axologl::error(text); break;
+        default: axologl::fatal(text); break;
+        }
+    }
+
+    /**
+     * Parse a record written by a worker. Returns false if the line isn't one; `intact` reports whether it is a
+     * correct one.
+     */
+    bool parseRecord(const Settings& settings, const std::string_view line, std::size_t& thread,
+                     std::uint64_t& sequence, axologl::LogLevel& level, bool& intact)
+    {
+        std::string_view body = line;
+        intact = false;
+        if (!axologl::levelFromLine(line, level)) return false;
+        body.remove_prefix(axologl::levelPrefixes[level].size() + 3);
+        if (body.empty() || body[0] != 't') return false;
+
+        char* end;
+        const std::string head(body.substr(0, std::min<std::size_t>(body.size(), 48)));
+        thread = std::strtoul(head.c_str() + 1, &end, 10);
+        if (end[0] != ' ' || end[1] != 'n') return true;
+        sequence = std::strtoull(end + 2, &end, 10);
+        if (*end != ' ') return true;
+        body.remove_prefix(end + 1 - head.c_str());
+
+        const std::size_t size = sizeFor(settings, thread, sequence);
+        if (body.size() != size || level != levelFor(settings, thread, sequence)) return true;
+        for (std::size_t i = 0; i < size; i++)
+        {
+            if (body[i] != payloadChar(thread, sequence, i)) return true;
+        }
+        intact = true;
+        return true;
+    }
+
+    // Records a `Batch` holds before it is committed, unless the level changes first
+    constexpr std::size_t batchRecords = 16;
+
+    struct Phase
+    {
+        const char* kind = "log";
+        std::size_t threads = 0;
+        double seconds = 0;
+        axologl::HistogramSnapshot latency;
+    };
+
+    bool parseArguments(const int argc, char** argv, Settings& settings)
+    {
+        parseMix("debug:1,info:4,notice:1,warn:2,error:1,fatal:1", settings.mix);
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string arg = argv[i];
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+            if (arg == "--no-reconfigure") settings.reconfigure = false;
+            else if (arg == "--console") settings.console = true;
+            else if (arg == "--async-console") settings.asyncConsole = true;
+            else if (value == nullptr) return false;
+            else if (arg == "--log") settings.logPath = argv[++i];
+            else if (arg == "--threads") settings.threads = parseList(argv[++i]);
+            else if (arg == "--records") settings.records = std::strtoul(argv[++i], nullptr, 10);
+            else if (arg == "--sizes") settings.sizes = parseList(argv[++i]);
+            else if (arg == "--mix")
+            {
+                if (!parseMix(argv[++i], settings.mix)) return false;
+            }
+            else if (arg == "--durability")
+            {
+                const std::string name = argv[++i];
+                if (name == "none") settings.durability = axologl::Durability::None;
+                else if (name == "on-error") settings.durability = axologl::Durability::OnError;
+                else if (name == "periodic") settings.durability = axologl::Durability::Periodic;
+                else return false;
+            }
+            else if (arg == "--overload")
+            {
+                const std::string name = argv[++i];
+                if (name == "block") settings.overload = axologl::Overload::Block;
+                else if (name == "drop") settings.overload = axologl::Overload::Drop;
+                else if (name == "sample") settings.overload = axologl::Overload::Sample;
+                else if (name == "block-for") settings.overload = axologl::Overload::BlockFor;
+                else return false;
+            }
+            else return false;
+        }
+        return !settings.threads.empty() && !settings.sizes.empty();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Settings settings;
+    if (!parseArguments(argc, argv, settings))
+    {
+        fprintf(stderr, "usage: %s [--log path] [--threads 1,2,4,8] [--records n] [--sizes 16,100,1000] "
+                        "[--mix debug:1,info:4,...] [--durability none|on-error|periodic] "
+                        "[--overload block|drop|sample|block-for] [--no-reconfigure] "
+                        "[--console] [--async-console]\n", argv[0]);
+        return 2;
+    }
+
+    // The report goes to stdout; the library's own console output is discarded unless asked for
+    FILE* report = stdout;
+    if (!settings.console)
+    {
+        std::cout.rdbuf(nullptr);
+        std::cerr.rdbuf(nullptr);
+    }
+
+    fs::remove(settings.logPath);
+    fs::remove(axologl::index::indexPathFor(settings.logPath));
+    PrintConsole console{true};
+    const axologl::AxologlOptions options;
+    options.logLevel = axologl::Debug;
+    options.logPath = settings.logPath;
+    options.console = &console;
+    options.indexLog = true;
+    options.tailRecords = 4096;
+    options.durability = settings.durability;
+    options.asyncConsole = settings.asyncConsole;
+    if (settings.overload != axologl::Overload::Block)
+    {
+        for (const axologl::LogLevel level : {axologl::Debug, axologl::Info, axologl::Notice})
+        {
+            options.overload[level] = {settings.overload, std::chrono::milliseconds(1), 4};
+        }
+        options.overload[axologl::Warning] = {axologl::Overload::BlockFor, std::chrono::milliseconds(1)};
+    }
+    options.syncInterval = std::chrono::milliseconds(20);
+    axologl::configure(options);
+
+    const axologl::StatsSnapshot before = axologl::stats();
+    std::vector<std::uint64_t> calls(axologl::levelCount);
+    std::vector<std::atomic<std::uint64_t>> callCounts(axologl::levelCount);
+
+    // Follows the tail the way a log viewer would; every record it sees must be intact too
+    std::atomic<bool> running = true;
+    std::atomic<std::uint64_t> tailSeen = 0;
+    std::atomic<std::uint64_t> tailCorrupt = 0;
+    std::thread tailReader([&]() {
+        axologl::TailCursor cursor = axologl::tail()->subscribe();
+        std::vector<axologl::TailRecord> records;
+        while (running.load())
+        {
+            records.clear();
+            axologl::tail()->poll(cursor, records, 256);
+            for (const auto& record : records)
+            {
+                std::size_t thread;
+                std::uint64_t sequence;
+                axologl::LogLevel level;
+                bool intact;
+                if (parseRecord(settings, record.text, thread, sequence, level, intact) && !intact
+                    && !record.truncated)
+                {
+                    tailCorrupt.fetch_add(1);
+                }
+            }
+            tailSeen.fetch_add(records.size());
+            if (records.empty()) std::this_thread::yield();
+        }
+    });
+
+    // Reconfigures the library at random while the workers run
+    std::thread reconfigurer([&]() {
+        std::uint64_t step = 0;
+        while (settings.reconfigure && running.load())
+        {
+            switch (mixHash(step++) % 4)
+            {
+            case 0: axologl::setLogLevel(mixLevels[mixHash(step) % 5]); break;
+            case 1: (step & 1) ? axologl::enableAnsi() : axologl::disableAnsi(); break;
+            case 2: (step & 2) ? axologl::enableNxLink(options.nxLinkOpts) : axologl::disableNxLink(); break;
+            default: axologl::setLogLevel(axologl::Debug); break;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    std::vector<Phase> phases;
+    std::size_t nextThread = 0;
+    // Runs `threads` workers, each calling `work(thread, latency)` to log its records, and numbers them after the
+    // workers of earlier phases so that every record in the file stays unique
+    const auto runPhase = [&](const char* kind, const std::size_t threads, const auto& work) {
+        Phase phase;
+        phase.kind = kind;
+        phase.threads = threads;
+        axologl::LatencyHistogram latency;
+
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; t++)
+        {
+            const std::size_t thread = nextThread + t;
+            workers.emplace_back([&, thread]() { work(thread, latency); });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        phase.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        phase.latency = latency.snapshot();
+        phases.push_back(phase);
+        nextThread += threads;
+    };
+
+    const auto logEach = [&](const std::size_t thread, axologl::LatencyHistogram& latency) {
+        for (std::uint64_t sequence = 0; sequence < settings.records; sequence++)
+        {
+            const axologl::LogLevel level = levelFor(settings, thread, sequence);
+            const std::string text = makeRecord(settings, thread, sequence);
+            const axologl::clock::Ticks begin = axologl::clock::now();
+            logAt(level, text);
+            latency.recordTicks(begin);
+            callCounts[level].fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    const auto logBatched = [&](const std::size_t thread, axologl::LatencyHistogram& latency) {
+        // A batch holds one level, so a change of level commits it and starts another
+        std::unique_ptr<axologl::Batch> batch;
+        axologl::LogLevel batchLevel = axologl::Raw;
+        std::size_t batched = 0;
+        for (std::uint64_t sequence = 0; sequence < settings.records; sequence++)
+        {
+            const axologl::LogLevel level = levelFor(settings, thread, sequence);
+            const std::string text = makeRecord(settings, thread, sequence);
+            const axologl::clock::Ticks begin = axologl::clock::now();
+            if (batch == nullptr || level != batchLevel || batched == batchRecords)
+            {
+                batch.reset();
+                batch = std::make_unique<axologl::Batch>(level);
+                batchLevel = level;
+                batched = 0;
+            }
+            batch->add(text);
+            batched++;
+            latency.recordTicks(begin);
+            callCounts[level].fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    for (const std::size_t threads : settings.threads)
+    {
+        runPhase("log", threads, logEach);
+    }
+    std::size_t mostThreads = 0;
+    for (const std::size_t threads : settings.threads) mostThreads = std::max(mostThreads, threads);
+    runPhase("batch", mostThreads, logBatched);
+
+    // The workers log into a shared-memory channel as a producer process would, and this process also plays the
+    // collector, writing what it drains to the same log file. A full channel drops records, counted like any drop.
+    const std::string channelName = "/axologl-stress-" + std::to_string(getpid());
+    axologl::SharedChannel channel(channelName.c_str(), 64 * 1024);
+    bool channelRan = false;
+    std::uint64_t channelNotices = 0;
+    if (channel.ready())
+    {
+        axologl::ChannelCollector collector;
+        collector.addChannel(&channel);
+        // This process is a producer too, so the collector's drop notices would be logged back into the channel;
+        // they are only counted. The drops they report are in `stats()` already.
+        const auto sink = [&channelNotices](const axologl::ChannelRecord& record) {
+            if (record.formatted) axologl::logCollected(record);
+            else channelNotices++;
+        };
+        std::atomic<bool> collecting = true;
+        std::thread collectorThread([&]() {
+            while (collecting.load())
+            {
+                if (collector.collect(sink) == 0)
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+            collector.collect(sink, true);
+        });
+
+        // No worker is running, so the channel can be swapped in under the loggers
+        axologl::_channel = &channel;
+        runPhase("channel", mostThreads, logEach);
+        axologl::_channel = nullptr;
+        collecting = false;
+        collectorThread.join();
+        channelRan = true;
+    }
+
+    running = false;
+    reconfigurer.join();
+    tailReader.join();
+    for (std::size_t i = 0; i < axologl::levelCount; i++)
+    {
+        calls[i] = callCounts[i].load();
+    }
+
+    // Counted after teardown so that its final drop summary is included
+    axologl::setLogLevel(axologl::Debug);
+    axologl::teardown();
+    const axologl::StatsSnapshot after = axologl::stats();
+    axologl::_tail.reset();
+    axologl::_fileLogger.reset();
+
+    // Read the log back
+    std::vector<std::uint64_t> nextSequence(nextThread, 0);
+    std::vector<std::uint64_t> found(axologl::levelCount);
+    std::uint64_t corrupt = 0;
+    std::uint64_t outOfOrder = 0;
+    std::uint64_t foreign = 0;
+    std::vector<std::uint64_t> summaries(axologl::levelCount);
+    std::ifstream log(settings.logPath);
+    std::string line;
+    while (std::getline(log, line))
+    {
+        std::size_t thread;
+        std::uint64_t sequence;
+        axologl::LogLevel level;
+        bool intact;
+        if (!parseRecord(settings, line, thread, sequence, level, intact))
+        {
+            // The library's own messages, e.g. "Axologl Initialised!"
+            axologl::LogLevel foreignLevel;
+            if (!axologl::levelFromLine(line, foreignLevel)) corrupt++;
+            else if (line.find("messages dropped under load") != std::string::npos) summaries[foreignLevel]++;
+            foreign++;
+            continue;
+        }
+        if (!intact || thread >= nextThread)
+        {
+            corrupt++;
+            continue;
+        }
+        if (sequence < nextSequence[thread]) outOfOrder++;
+        nextSequence[thread] = sequence + 1;
+        found[level]++;
+    }
+
+    bool ok = corrupt == 0 && outOfOrder == 0 && tailCorrupt.load() == 0 && channelRan;
+    std::uint64_t missing = 0;
+    for (std::size_t i = 0; i < axologl::levelCount; i++)
+    {
+        // Besides the workers' records, the library wrote any drop summaries and "Axologl shutting down..."
+        const std::uint64_t written = after.messages[i] - before.messages[i] - summaries[i] - (i == axologl::Debug);
+        const std::uint64_t filtered = after.filtered[i] - before.filtered[i];
+        if (written != found[i] || found[i] + filtered > calls[i])
+        {
+            fprintf(report, "level %s: %llu calls, %llu in file, stats say %llu written and %llu filtered\n",
+                    mixNames[i], static_cast<unsigned long long>(calls[i]),
+                    static_cast<unsigned long long>(found[i]), static_cast<unsigned long long>(written),
+                    static_cast<unsigned long long>(filtered));
+            ok = false;
+        }
+        missing += calls[i] - found[i] - filtered;
+    }
+    // Anything neither written nor filtered must have been counted as dropped
+    const std::uint64_t drops = after.drops - before.drops;
+    if (missing != drops)
+    {
+        ok = false;
+    }
+
+    fprintf(report, "phase     threads   records/s        p50 ns      p99 ns     p999 ns\n");
+    for (const Phase& phase : phases)
+    {
+        fprintf(report, "%-9s %7zu %11.0f %13llu %11llu %11llu\n", phase.kind, phase.threads,
+                static_cast<double>(phase.threads * settings.records) / phase.seconds,
+                static_cast<unsigned long long>(phase.latency.percentile(0.5)),
+                static_cast<unsigned long long>(phase.latency.percentile(0.99)),
+                static_cast<unsigned long long>(phase.latency.percentile(0.999)));
+    }
+
+    std::uint64_t total = 0;
+    for (const std::uint64_t c : calls) total += c;
+    std::uint64_t written = 0;
+    for (const std::uint64_t f : found) written += f;
+    fprintf(report, "records: %llu logged, %llu written, %llu filtered or dropped (%llu dropped), %llu other lines\n",
+            static_cast<unsigned long long>(total), static_cast<unsigned long long>(written),
+            static_cast<unsigned long long>(total - written), static_cast<unsigned long long>(drops),
+            static_cast<unsigned long long>(foreign));
+    fprintf(report, "channel: %llu drop notices from the collector\n", static_cast<unsigned long long>(channelNotices));
+    fprintf(report, "tail: %llu records seen, %llu corrupt\n", static_cast<unsigned long long>(tailSeen.load()),
+            static_cast<unsigned long long>(tailCorrupt.load()));
+    fprintf(report, "file: %llu corrupt, %llu out of order, %llu unaccounted for\n",
+            static_cast<unsigned long long>(corrupt), static_cast<unsigned long long>(outOfOrder),
+            static_cast<unsigned long long>(missing - drops));
+    if (!channelRan) fprintf(report, "channel: unable to create %s\n", channelName.c_str());
+    fprintf(report, "%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Prints the lines of an indexed log file (written with `AxologlOptions::indexLog`) that match a level and time range,
+// reading only the blocks the sidecar index says can match.
+//
+// Usage: axologl-query <logfile> [--level <debug|info|notice|warn|error|fatal>] [--since <unix seconds>]
+//                                [--until <unix seconds>] [--stats]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "index.h"
+
+namespace
+{
+    bool parseLevel(const char* name, axologl::LogLevel& level)
+    {
+        std::string upper(name);
+        for (char& c : upper) c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+        for (int i = axologl::Debug; i <= axologl::Raw; i++)
+        {
+            if (upper == axologl::levelPrefixes[i])
+            {
+                level = static_cast<axologl::LogLevel>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int usage(const char* self)
+    {
+        fprintf(stderr, "Usage: %s <logfile> [--level <debug|info|notice|warn|error|fatal>] "
+                        "[--since <unix seconds>] [--until <unix seconds>] [--stats]\n", self);
+        return 1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        return usage(argv[0]);
+    }
+
+    axologl::index::Query query;
+    bool printStats = false;
+    for (int i = 2; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--level") == 0 && hasValue)
+        {
+            if (!parseLevel(argv[++i], query.minLevel)) return usage(argv[0]);
+        }
+        else if (std::strcmp(argv[i], "--since") == 0 && hasValue)
+        {
+            query.since = std::strtoull(argv[++i], nullptr, 10) * 1000;
+        }
+        else if (std::strcmp(argv[i], "--until") == 0 && hasValue)
+        {
+            query.until = std::strtoull(argv[++i], nullptr, 10) * 1000 + 999;
+        }
+        else if (std::strcmp(argv[i], "--stats") == 0)
+        {
+            printStats = true;
+        }
+        else
+        {
+            return usage(argv[0]);
+        }
+    }
+
+    axologl::index::IndexedLog log(argv[1]);
+    if (!log.ready())
+    {
+        fprintf(stderr, "%s: unable to open the log or its index (%s)\n", argv[1],
+                axologl::index::indexPathFor(argv[1]).c_str());
+        return 1;
+    }
+
+    const axologl::index::QueryStats stats = log.query(query, [](const std::string_view line, axologl::LogLevel) {
+        fwrite(line.data(), 1, line.size(), stdout);
+        fputc('\n', stdout);
+    });
+
+    if (printStats)
+    {
+        fprintf(stderr, "%zu blocks indexed, %zu read, %zu skipped, %zu damaged, %llu bytes read\n",
+                log.getEntries().size(), stats.blocksRead, stats.blocksSkipped, stats.blocksDamaged,
+                static_cast<unsigned long long>(stats.bytesRead));
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ *     Axologl - A simple logging library designed to integrate with libnx
+ *     Copyright (C) 2026. Xerat0nin
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Decompresses a log file written with `AxologlOptions::compressLog` back into plain text.
+//
+// Usage: axologl-unpack <input.axlz> [output.log]
+//
+// Output goes to stdout unless a path is given. Blocks cut short by a crash or power loss are skipped, and decoding
+// carries on with the session written after them; the exit status is then 2 so that scripts can tell.
+
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+
+#include "compress.h"
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "Usage: %s <input.axlz> [output.log]\n", argv[0]);
+        return 1;
+    }
+
+    FILE* input = fopen(argv[1], "rb");
+    if (input == nullptr)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    FILE* output = argc == 3 ? fopen(argv[2], "wb") : stdout;
+    if (output == nullptr)
+    {
+        perror(argv[2]);
+        fclose(input);
+        return 1;
+    }
+
+    axologl::compress::FrameReader reader(input);
+    std::string block;
+    std::size_t blocks = 0;
+    while (reader.next(block))
+    {
+        fwrite(block.data(), 1, block.size(), output);
+        blocks++;
+    }
+
+    int status = 0;
+    if (reader.damagedRegions() != 0)
+    {
+        fprintf(stderr, "%s: skipped %" PRIu64 " damaged bytes in %zu places%s; decoded %zu complete blocks\n",
+                argv[1], reader.damagedBytes(), reader.damagedRegions(),
+                reader.truncated() ? ", including the end of the file" : "", blocks);
+        status = 2;
+    }
+
+    if (output != stdout) fclose(output);
+    fclose(input);
+    return status;
+}